@@ -2,9 +2,18 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <new>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <type_traits>
+#include <cstdlib>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #ifdef _WIN32
 #include <direct.h>
 #else
@@ -14,7 +23,19 @@
 
 // ============ 页式存储配置 ============
 const int PAGE_SIZE = 4096;  // 4KB页大小
-const int MAX_KEYS_PER_PAGE = 100;  // 每页最大键数
+const int MAX_TREE_HEIGHT = 32;  // 下降路径记录的最大层数
+const int MULTI_GET_GROUP = 16;  // 批量查找时同步推进的查找个数
+const int CACHE_LINE_SIZE = 64;
+const int PREFETCH_WHOLE_LINES = 4;  // 键数组不超过此缓存行数时整段预取
+const int INTERPOLATION_MIN_KEYS = 16;  // 叶子键数少于此值时直接二分查找
+const int INTERPOLATION_SAMPLES = 8;    // 评估键分布偏斜度时的采样点数
+
+// 软件预取（不支持的编译器上为空操作）
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)0)
+#endif
 
 using PageID = uint32_t;
 const PageID INVALID_PAGE_ID = 0;
@@ -22,77 +43,199 @@ const PageID INVALID_PAGE_ID = 0;
 // ============ 页类型枚举 ============
 enum PageType : uint8_t {
     INTERNAL_PAGE = 1,
-    LEAF_PAGE = 2
+    LEAF_PAGE = 2,
+    OVERFLOW_PAGE = 3
 };
 
 // ============ 页头结构 ============
 struct PageHeader {
     PageType pageType;
+    uint8_t interpolationSearch;  // 仅叶子页：键分布接近均匀时为 1，页内查找使用插值
+    uint16_t pinCount;            // 被钉住的次数（只在内存中有意义，占用原有的对齐填充）
     uint32_t keyCount;
-    PageID parentPageId;
     PageID nextPageId;  // 仅用于叶子节点链表
     PageID prevPageId;  // 仅用于叶子节点链表
     
-    PageHeader() : pageType(LEAF_PAGE), keyCount(0), 
-                   parentPageId(INVALID_PAGE_ID),
+    PageHeader() : pageType(LEAF_PAGE), interpolationSearch(0), pinCount(0), keyCount(0), 
                    nextPageId(INVALID_PAGE_ID),
                    prevPageId(INVALID_PAGE_ID) {}
 };
 
-// ============ 页结构（修复：不使用union，分开存储） ============
-template<typename KeyType, typename ValueType>
+// ============ 页结构：公共页头 + 叶子/内部两种布局 ============
+// 缓冲池按页头中的 pageType 把 Page* 转换为具体布局
 struct Page {
     PageHeader header;
-    KeyType keys[MAX_KEYS_PER_PAGE];
-    PageID children[MAX_KEYS_PER_PAGE + 1];  // 内部节点使用
-    ValueType values[MAX_KEYS_PER_PAGE];      // 叶子节点使用
-    
-    Page() {
-        header = PageHeader();
-        memset(keys, 0, sizeof(keys));
-        memset(children, 0, sizeof(children));
-        // values会自动初始化
+};
+
+// 叶子页：键数组 + 值数组，容量由 PAGE_SIZE 与键值大小在编译期推导
+template<typename KeyType, typename ValueType>
+struct LeafPage : public Page {
+    // 预留 alignof(ValueType) 字节吸收两个数组之间的对齐填充
+    static const uint32_t CAPACITY =
+        (PAGE_SIZE - sizeof(Page) - alignof(ValueType)) / (sizeof(KeyType) + sizeof(ValueType));
+
+    KeyType keys[CAPACITY];
+    ValueType values[CAPACITY];
+
+    LeafPage() : keys(), values() {
+        header.pageType = LEAF_PAGE;
     }
-    
-    // 显式析构函数
-    ~Page() {
-        // ValueType的析构会自动调用
+};
+
+template<typename KeyType, typename ValueType>
+const uint32_t LeafPage<KeyType, ValueType>::CAPACITY;
+
+// 子树条目计数（顺序统计：rank / select / 范围计数）
+// 与 PageID 同为 32 位：每个孩子多占 4 字节而不是 8 字节，内部页扇出更大；单棵树最多 2^32 - 1 个条目
+typedef uint32_t SubtreeCount;
+
+// 内部页：键数组 + 孩子数组（比键多一个）+ 每个孩子子树中的条目数
+template<typename KeyType>
+struct InternalPage : public Page {
+    static const uint32_t CAPACITY =
+        (PAGE_SIZE - sizeof(Page) - sizeof(PageID) - sizeof(SubtreeCount) - alignof(PageID) - alignof(SubtreeCount)) /
+        (sizeof(KeyType) + sizeof(PageID) + sizeof(SubtreeCount));
+
+    KeyType keys[CAPACITY];
+    PageID children[CAPACITY + 1];
+    SubtreeCount counts[CAPACITY + 1];
+
+    InternalPage() : keys(), children(), counts() {
+        header.pageType = INTERNAL_PAGE;
+    }
+};
+
+template<typename KeyType>
+const uint32_t InternalPage<KeyType>::CAPACITY;
+
+// 溢出页：存放放不进叶子的字节流，header.keyCount 为已用字节数，header.nextPageId 串成链
+struct OverflowPage : public Page {
+    static const uint32_t CAPACITY = PAGE_SIZE - sizeof(Page);
+
+    uint8_t data[CAPACITY];
+
+    OverflowPage() {
+        header.pageType = OVERFLOW_PAGE;
     }
 };
 
+const uint32_t OverflowPage::CAPACITY;
+
+// ============ 页内元素搬移 ============
+// 把 [first, last) 搬到 dest 开始的位置，源区间与目标区间可以重叠
+// 可平凡复制的类型整段 memmove，其余类型按方向逐个移动赋值
+template<typename T>
+inline void moveRange(T* first, T* last, T* dest, std::true_type) {
+    if (first != last) std::memmove(static_cast<void*>(dest), first, (last - first) * sizeof(T));
+}
+
+template<typename T>
+inline void moveRange(T* first, T* last, T* dest, std::false_type) {
+    if (dest < first) {
+        std::move(first, last, dest);
+    } else {
+        std::move_backward(first, last, dest + (last - first));
+    }
+}
+
+template<typename T>
+inline void moveRange(T* first, T* last, T* dest) {
+    moveRange(first, last, dest, std::is_trivially_copyable<T>());
+}
+
 // ============ 缓冲池管理器 ============
 template<typename KeyType, typename ValueType>
 class BufferPoolManager {
+public:
+    typedef LeafPage<KeyType, ValueType> LeafPageType;
+    typedef InternalPage<KeyType> InternalPageType;
+
+    static_assert(sizeof(LeafPageType) <= PAGE_SIZE, "叶子页布局超过 PAGE_SIZE");
+    static_assert(sizeof(InternalPageType) <= PAGE_SIZE, "内部页布局超过 PAGE_SIZE");
+    static_assert(LeafPageType::CAPACITY >= 2 && InternalPageType::CAPACITY >= 2, "键值过大，一页放不下两个条目");
+
 private:
-    std::unordered_map<PageID, Page<KeyType, ValueType>*> pageTable;
+    std::unordered_map<PageID, Page*> pageTable;
+    std::vector<PageID> freePageIds;  // 已释放、可复用的页ID
+    std::unordered_set<PageID> dirtyPageIds;  // 已修改但推迟落盘的页面（由 flushDirtyPages 统一写出）
     PageID nextPageId;
+
+    // 按页类型析构并归还一整页内存
+    static void destroyPage(Page* page) {
+        if (page->header.pageType == LEAF_PAGE) {
+            static_cast<LeafPageType*>(page)->~LeafPageType();
+        } else if (page->header.pageType == OVERFLOW_PAGE) {
+            static_cast<OverflowPage*>(page)->~OverflowPage();
+        } else {
+            static_cast<InternalPageType*>(page)->~InternalPageType();
+        }
+        ::operator delete(page);
+    }
+
+    // 在一整页（PAGE_SIZE 字节）内存上构造指定布局
+    template<typename PageLayout>
+    PageLayout* createPage(PageID pageId) {
+        deletePage(pageId);
+        PageLayout* page = new (::operator new(PAGE_SIZE)) PageLayout();
+        pageTable[pageId] = page;
+        return page;
+    }
     
 public:
     BufferPoolManager() : nextPageId(1) {}
     
     ~BufferPoolManager() {
-        for (typename std::unordered_map<PageID, Page<KeyType, ValueType>*>::iterator it = pageTable.begin(); 
+        for (typename std::unordered_map<PageID, Page*>::iterator it = pageTable.begin(); 
              it != pageTable.end(); ++it) {
-            delete it->second;
+            destroyPage(it->second);
         }
     }
     
-    // 分配新页面
+    // 分配新页面（优先复用已释放的页）
     PageID allocatePage() {
+        if (!freePageIds.empty()) {
+            PageID pageId = freePageIds.back();
+            freePageIds.pop_back();
+            return pageId;
+        }
         return nextPageId++;
     }
+
+    // 为已分配的页ID创建空的叶子页/内部页
+    LeafPageType* newLeafPage(PageID pageId) {
+        return createPage<LeafPageType>(pageId);
+    }
+
+    InternalPageType* newInternalPage(PageID pageId) {
+        return createPage<InternalPageType>(pageId);
+    }
+
+    OverflowPage* newOverflowPage(PageID pageId) {
+        return createPage<OverflowPage>(pageId);
+    }
     
-    // 获取页面（如果不存在则创建）
-    Page<KeyType, ValueType>* fetchPage(PageID pageId) {
-        if (pageTable.find(pageId) == pageTable.end()) {
-            pageTable[pageId] = new Page<KeyType, ValueType>();
-        }
-        return pageTable[pageId];
+    // 获取页面（不存在时返回 NULL）
+    Page* fetchPage(PageID pageId) {
+        typename std::unordered_map<PageID, Page*>::iterator it = pageTable.find(pageId);
+        return it != pageTable.end() ? it->second : NULL;
+    }
+
+    LeafPageType* fetchLeafPage(PageID pageId) {
+        return static_cast<LeafPageType*>(fetchPage(pageId));
+    }
+
+    InternalPageType* fetchInternalPage(PageID pageId) {
+        return static_cast<InternalPageType*>(fetchPage(pageId));
+    }
+
+    OverflowPage* fetchOverflowPage(PageID pageId) {
+        return static_cast<OverflowPage*>(fetchPage(pageId));
     }
     
     // 刷新页面到磁盘（将页面序列化为可读文本文件，便于验证）
     void flushPage(PageID pageId) {
-        Page<KeyType, ValueType>* page = fetchPage(pageId);
+        Page* page = fetchPage(pageId);
+        dirtyPageIds.erase(pageId);
         std::cout << "[DISK I/O] 刷新页面 " << pageId << " 到磁盘\n";
 
     try {
@@ -111,28 +254,46 @@ public:
             ofs << "PageID: " << pageId << "\n";
             ofs << "PageType: " << (int)page->header.pageType << "\n";
             ofs << "KeyCount: " << page->header.keyCount << "\n";
-            ofs << "ParentPageId: " << page->header.parentPageId << "\n";
+            ofs << "InterpolationSearch: " << (int)page->header.interpolationSearch << "\n";
             ofs << "NextPageId: " << page->header.nextPageId << "\n";
             ofs << "PrevPageId: " << page->header.prevPageId << "\n";
 
-            ofs << "Keys:\n";
-            for (uint32_t i = 0; i < page->header.keyCount; i++) {
-                ofs << page->keys[i];
-                if (i + 1 < page->header.keyCount) ofs << '\t';
-            }
-            ofs << "\n";
-
             if (page->header.pageType == INTERNAL_PAGE) {
+                InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+                ofs << "Keys:\n";
+                for (uint32_t i = 0; i < page->header.keyCount; i++) {
+                    ofs << internalPage->keys[i];
+                    if (i + 1 < page->header.keyCount) ofs << '\t';
+                }
+                ofs << "\n";
+
                 ofs << "Children:\n";
                 for (uint32_t i = 0; i <= page->header.keyCount; i++) {
-                    ofs << page->children[i];
+                    ofs << internalPage->children[i];
+                    if (i < page->header.keyCount) ofs << '\t';
+                }
+                ofs << "\n";
+
+                ofs << "Counts:\n";
+                for (uint32_t i = 0; i <= page->header.keyCount; i++) {
+                    ofs << internalPage->counts[i];
                     if (i < page->header.keyCount) ofs << '\t';
                 }
                 ofs << "\n";
+            } else if (page->header.pageType == OVERFLOW_PAGE) {
+                ofs << "Bytes: " << page->header.keyCount << "\n";
             } else {
+                LeafPageType* leafPage = static_cast<LeafPageType*>(page);
+                ofs << "Keys:\n";
+                for (uint32_t i = 0; i < page->header.keyCount; i++) {
+                    ofs << leafPage->keys[i];
+                    if (i + 1 < page->header.keyCount) ofs << '\t';
+                }
+                ofs << "\n";
+
                 ofs << "Values:\n";
                 for (uint32_t i = 0; i < page->header.keyCount; i++) {
-                    ofs << page->values[i];
+                    ofs << leafPage->values[i];
                     if (i + 1 < page->header.keyCount) ofs << '\t';
                 }
                 ofs << "\n";
@@ -144,12 +305,55 @@ public:
         }
     }
     
+    // 标记页面已修改、稍后落盘：同一页在两次落盘之间被反复修改时只写一次
+    void markDirty(PageID pageId) {
+        dirtyPageIds.insert(pageId);
+    }
+
+    // 写出全部脏页
+    void flushDirtyPages() {
+        while (!dirtyPageIds.empty()) {
+            flushPage(*dirtyPageIds.begin());
+        }
+    }
+
+    size_t getDirtyPageCount() const { return dirtyPageIds.size(); }
+
     // 删除页面
     void deletePage(PageID pageId) {
-        if (pageTable.find(pageId) != pageTable.end()) {
-            delete pageTable[pageId];
-            pageTable.erase(pageId);
+        typename std::unordered_map<PageID, Page*>::iterator it = pageTable.find(pageId);
+        if (it != pageTable.end()) {
+            destroyPage(it->second);
+            pageTable.erase(it);
+        }
+        dirtyPageIds.erase(pageId);
+    }
+
+    // 释放页面：删除内存中的页并把页ID归还给分配器
+    void deallocatePage(PageID pageId) {
+        if (isPinned(pageId)) {
+            std::cerr << "[WARN] 释放仍被钉住的页面 " << pageId << "\n";
         }
+        deletePage(pageId);
+        freePageIds.push_back(pageId);
+    }
+
+    // 钉住页面：游标等长期持有页面指针的使用者在持有期间调用
+    // 计数保存在页头中，切换页面时只做查表，不分配内存
+    Page* pinPage(PageID pageId) {
+        Page* page = fetchPage(pageId);
+        if (page != NULL) page->header.pinCount++;
+        return page;
+    }
+
+    void unpinPage(PageID pageId) {
+        Page* page = fetchPage(pageId);
+        if (page != NULL && page->header.pinCount > 0) page->header.pinCount--;
+    }
+
+    bool isPinned(PageID pageId) {
+        Page* page = fetchPage(pageId);
+        return page != NULL && page->header.pinCount > 0;
     }
     
     // 获取统计信息
@@ -159,281 +363,2298 @@ public:
         std::cout << "=== 缓冲池统计 ===\n";
         std::cout << "总页数: " << pageTable.size() << "\n";
         std::cout << "下一个页ID: " << nextPageId << "\n";
-        std::cout << "页面大小: " << sizeof(Page<KeyType, ValueType>) << " 字节\n";
+        std::cout << "空闲页数: " << freePageIds.size() << "\n";
+        std::cout << "脏页数: " << dirtyPageIds.size() << "\n";
+        std::cout << "页面大小: " << PAGE_SIZE << " 字节 (叶子布局 " << sizeof(LeafPageType)
+                  << " 字节/" << LeafPageType::CAPACITY << " 键, 内部布局 " << sizeof(InternalPageType)
+                  << " 字节/" << InternalPageType::CAPACITY << " 键)\n";
     }
 };
 
-// ============ 页式B+树 ============
-template<typename KeyType, typename ValueType>
-class PagedBPlusTree {
-private:
-    BufferPoolManager<KeyType, ValueType> bufferPool;
-    PageID rootPageId;
-    PageID firstLeafPageId;
-    int order;
-    
-    // 查找叶子页面
-    PageID findLeafPage(KeyType key) {
-        PageID currentPageId = rootPageId;
-        
-        while (true) {
-            Page<KeyType, ValueType>* page = bufferPool.fetchPage(currentPageId);
-            
-            if (page->header.pageType == LEAF_PAGE) {
-                return currentPageId;
-            }
-            
-            // 内部节点，查找子节点
-            int pos = 0;
-            while (pos < (int)page->header.keyCount && key >= page->keys[pos]) {
-                pos++;
+// ============ 范围聚合 ============
+// 聚合器接口：accumulate(values, n) 接收叶子内连续的一段值（直接指向页内数组）
+// ValueAggregate 一次求 count/sum/min/max，内层循环用多个独立累加器，便于编译器向量化
+// 求和在加宽的 SumType 中进行（整数为 64 位，浮点至少为 double），避免窄整数值的和溢出
+template<typename ValueType>
+struct ValueAggregate {
+    static_assert(std::is_arithmetic<ValueType>::value, "ValueAggregate 仅支持算术类型的值");
+
+    typedef typename std::conditional<
+        std::is_floating_point<ValueType>::value, typename std::common_type<ValueType, double>::type,
+        typename std::conditional<std::is_signed<ValueType>::value, int64_t, uint64_t>::type>::type SumType;
+
+    size_t count;
+    SumType sum;
+    ValueType min;
+    ValueType max;
+
+    ValueAggregate() : count(0), sum(0), min(0), max(0) {}
+
+    void accumulate(const ValueType* values, size_t n) {
+        if (n == 0) return;
+        if (count == 0) min = max = values[0];
+
+        SumType sums[4] = {0, 0, 0, 0};
+        ValueType mins[4] = {min, min, min, min};
+        ValueType maxs[4] = {max, max, max, max};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (int lane = 0; lane < 4; lane++) {
+                ValueType v = values[i + lane];
+                sums[lane] += v;
+                mins[lane] = v < mins[lane] ? v : mins[lane];
+                maxs[lane] = maxs[lane] < v ? v : maxs[lane];
             }
-            currentPageId = page->children[pos];
         }
-    }
-    
-    // 分裂叶子页面
-    void splitLeafPage(PageID leafPageId, KeyType key, ValueType value) {
-        Page<KeyType, ValueType>* leafPage = bufferPool.fetchPage(leafPageId);
-        PageID newLeafPageId = bufferPool.allocatePage();
-        Page<KeyType, ValueType>* newLeafPage = bufferPool.fetchPage(newLeafPageId);
-        
-        newLeafPage->header.pageType = LEAF_PAGE;
-        
-        std::cout << "[SPLIT] 分裂叶子页面 " << leafPageId << " -> " << newLeafPageId << "\n";
-        
-        // 临时数组
-        std::vector<KeyType> tempKeys(leafPage->keys, leafPage->keys + leafPage->header.keyCount);
-        std::vector<ValueType> tempValues(leafPage->values, leafPage->values + leafPage->header.keyCount);
-        
-        // 插入新键值
-        int pos = 0;
-        while (pos < (int)tempKeys.size() && tempKeys[pos] < key) pos++;
-        tempKeys.insert(tempKeys.begin() + pos, key);
-        tempValues.insert(tempValues.begin() + pos, value);
-        
-        // 分裂点
-        int mid = (order + 1) / 2;
-        
-        // 左半部分
-        leafPage->header.keyCount = mid;
-        std::copy(tempKeys.begin(), tempKeys.begin() + mid, leafPage->keys);
-        std::copy(tempValues.begin(), tempValues.begin() + mid, leafPage->values);
-        
-        // 右半部分
-        newLeafPage->header.keyCount = tempKeys.size() - mid;
-        std::copy(tempKeys.begin() + mid, tempKeys.end(), newLeafPage->keys);
-        std::copy(tempValues.begin() + mid, tempValues.end(), newLeafPage->values);
-        
-        // 更新链表指针
-        newLeafPage->header.nextPageId = leafPage->header.nextPageId;
-        newLeafPage->header.prevPageId = leafPageId;
-        if (leafPage->header.nextPageId != INVALID_PAGE_ID) {
-            Page<KeyType, ValueType>* nextPage = bufferPool.fetchPage(leafPage->header.nextPageId);
-            nextPage->header.prevPageId = newLeafPageId;
+        for (; i < n; i++) {
+            sums[0] += values[i];
+            mins[0] = values[i] < mins[0] ? values[i] : mins[0];
+            maxs[0] = maxs[0] < values[i] ? values[i] : maxs[0];
         }
-        leafPage->header.nextPageId = newLeafPageId;
-        
-        // 向父节点插入
-        if (leafPageId == rootPageId) {
-            PageID newRootPageId = bufferPool.allocatePage();
-            Page<KeyType, ValueType>* newRootPage = bufferPool.fetchPage(newRootPageId);
-            newRootPage->header.pageType = INTERNAL_PAGE;
-            newRootPage->header.keyCount = 1;
-            newRootPage->keys[0] = newLeafPage->keys[0];
-            newRootPage->children[0] = leafPageId;
-            newRootPage->children[1] = newLeafPageId;
-            
-            leafPage->header.parentPageId = newRootPageId;
-            newLeafPage->header.parentPageId = newRootPageId;
-            rootPageId = newRootPageId;
-            
-            std::cout << "[ROOT] 创建新根页面 " << newRootPageId << "\n";
-        } else {
-            newLeafPage->header.parentPageId = leafPage->header.parentPageId;
-            insertInternal(newLeafPage->keys[0], leafPage->header.parentPageId, newLeafPageId);
+        for (int lane = 0; lane < 4; lane++) {
+            sum += sums[lane];
+            min = mins[lane] < min ? mins[lane] : min;
+            max = max < maxs[lane] ? maxs[lane] : max;
         }
-        
-        bufferPool.flushPage(leafPageId);
-        bufferPool.flushPage(newLeafPageId);
+        count += n;
     }
-    
-    // 分裂内部页面
-    void splitInternalPage(PageID internalPageId, KeyType key, PageID childPageId) {
-        Page<KeyType, ValueType>* internalPage = bufferPool.fetchPage(internalPageId);
-        PageID newInternalPageId = bufferPool.allocatePage();
-        Page<KeyType, ValueType>* newInternalPage = bufferPool.fetchPage(newInternalPageId);
-        
-        newInternalPage->header.pageType = INTERNAL_PAGE;
-        
-        std::cout << "[SPLIT] 分裂内部页面 " << internalPageId << " -> " << newInternalPageId << "\n";
-        
-        // 临时数组
-        std::vector<KeyType> tempKeys(internalPage->keys, internalPage->keys + internalPage->header.keyCount);
-        std::vector<PageID> tempChildren(internalPage->children, internalPage->children + internalPage->header.keyCount + 1);
-        
-        // 插入新键和子节点
-        int pos = 0;
-        while (pos < (int)tempKeys.size() && tempKeys[pos] < key) pos++;
-        tempKeys.insert(tempKeys.begin() + pos, key);
-        tempChildren.insert(tempChildren.begin() + pos + 1, childPageId);
-        
-        // 分裂点
-        int mid = (order + 1) / 2;
-        KeyType midKey = tempKeys[mid];
-        
-        // 左半部分
-        internalPage->header.keyCount = mid;
-        std::copy(tempKeys.begin(), tempKeys.begin() + mid, internalPage->keys);
-        std::copy(tempChildren.begin(), tempChildren.begin() + mid + 1, internalPage->children);
-        
-        // 右半部分
-        newInternalPage->header.keyCount = tempKeys.size() - mid - 1;
-        std::copy(tempKeys.begin() + mid + 1, tempKeys.end(), newInternalPage->keys);
-        std::copy(tempChildren.begin() + mid + 1, tempChildren.end(), newInternalPage->children);
-        
-        // 更新子节点的父指针
-        for (int i = 0; i <= (int)newInternalPage->header.keyCount; i++) {
-            Page<KeyType, ValueType>* childPage = bufferPool.fetchPage(newInternalPage->children[i]);
-            childPage->header.parentPageId = newInternalPageId;
+};
+
+// ============ 叶子布隆过滤器 ============
+// 每个叶子一个，只在内存中维护；删除键时不清除位（仅增加误判），分裂/合并时按页重建
+const int BLOOM_BITS_PER_KEY = 10;
+const int BLOOM_HASH_COUNT = 7;
+
+class BloomFilter {
+private:
+    std::vector<uint64_t> bits;
+
+    // 对 std::hash 的结果再做一次混洗（整数的 std::hash 通常是恒等映射）
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+public:
+    explicit BloomFilter(size_t expectedKeys = 1)
+        : bits((std::max<size_t>(expectedKeys, 1) * BLOOM_BITS_PER_KEY + 63) / 64, 0) {}
+
+    void clear() {
+        std::fill(bits.begin(), bits.end(), 0);
+    }
+
+    // 双重哈希：第 i 个位置为 h1 + i * h2
+    void add(size_t hash) {
+        uint64_t h1 = mix(hash);
+        uint64_t h2 = (h1 >> 32) | 1;
+        uint64_t bitCount = bits.size() * 64;
+        for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+            uint64_t bit = (h1 + i * h2) % bitCount;
+            bits[bit / 64] |= 1ULL << (bit % 64);
         }
-        
-        // 向父节点插入
-        if (internalPageId == rootPageId) {
-            PageID newRootPageId = bufferPool.allocatePage();
-            Page<KeyType, ValueType>* newRootPage = bufferPool.fetchPage(newRootPageId);
-            newRootPage->header.pageType = INTERNAL_PAGE;
-            newRootPage->header.keyCount = 1;
-            newRootPage->keys[0] = midKey;
-            newRootPage->children[0] = internalPageId;
-            newRootPage->children[1] = newInternalPageId;
-            
-            internalPage->header.parentPageId = newRootPageId;
-            newInternalPage->header.parentPageId = newRootPageId;
-            rootPageId = newRootPageId;
-            
-            std::cout << "[ROOT] 创建新根页面 " << newRootPageId << "\n";
-        } else {
-            newInternalPage->header.parentPageId = internalPage->header.parentPageId;
-            insertInternal(midKey, internalPage->header.parentPageId, newInternalPageId);
+    }
+
+    bool mayContain(size_t hash) const {
+        uint64_t h1 = mix(hash);
+        uint64_t h2 = (h1 >> 32) | 1;
+        uint64_t bitCount = bits.size() * 64;
+        for (int i = 0; i < BLOOM_HASH_COUNT; i++) {
+            uint64_t bit = (h1 + i * h2) % bitCount;
+            if ((bits[bit / 64] & (1ULL << (bit % 64))) == 0) return false;
         }
-        
-        bufferPool.flushPage(internalPageId);
-        bufferPool.flushPage(newInternalPageId);
+        return true;
     }
-    
-    // 向内部节点插入
-    void insertInternal(KeyType key, PageID internalPageId, PageID childPageId) {
-        Page<KeyType, ValueType>* internalPage = bufferPool.fetchPage(internalPageId);
-        
-        if (internalPage->header.keyCount < (uint32_t)(order - 1)) {
-            int pos = 0;
-            while (pos < (int)internalPage->header.keyCount && internalPage->keys[pos] < key) pos++;
-            
-            // 移动键和子节点
-            for (int i = internalPage->header.keyCount; i > pos; i--) {
-                internalPage->keys[i] = internalPage->keys[i - 1];
-                internalPage->children[i + 1] = internalPage->children[i];
-            }
-            
-            internalPage->keys[pos] = key;
-            internalPage->children[pos + 1] = childPageId;
-            internalPage->header.keyCount++;
-            
-            Page<KeyType, ValueType>* childPage = bufferPool.fetchPage(childPageId);
-            childPage->header.parentPageId = internalPageId;
-            
-            bufferPool.flushPage(internalPageId);
-        } else {
-            splitInternalPage(internalPageId, key, childPageId);
+};
+
+// 键类型是否有可用的 std::hash（没有时不能启用布隆过滤器，但树本身不受影响）
+template<typename T, typename = void>
+struct HasStdHash : std::false_type {};
+
+template<typename T>
+struct HasStdHash<T, decltype((void)std::hash<T>()(std::declval<const T&>()))> : std::true_type {};
+
+// ============ 倒排列表（非唯一索引的值） ============
+// 一个键对应的全部行号，升序排列并以 varint 增量编码（首个值为绝对值）
+// 编码结果较小时内联在叶子值中，超过 POSTING_INLINE_BYTES 后整体转入溢出页链
+const int POSTING_INLINE_BYTES = 32;
+const int MAX_VARINT_BYTES = 10;
+
+struct PostingList {
+    uint32_t count;          // 行号个数
+    uint32_t byteCount;      // 编码后的总字节数
+    uint64_t lastValue;      // 最大行号（追加时据此计算增量）
+    PageID overflowPageId;   // 溢出链首页，INVALID_PAGE_ID 表示内联
+    PageID tailPageId;       // 溢出链尾页，追加时直接定位
+    uint8_t inlineData[POSTING_INLINE_BYTES];
+
+    PostingList() : count(0), byteCount(0), lastValue(0),
+                    overflowPageId(INVALID_PAGE_ID), tailPageId(INVALID_PAGE_ID), inlineData() {}
+};
+
+// 页面落盘时只输出摘要
+inline std::ostream& operator<<(std::ostream& os, const PostingList& list) {
+    os << "[" << list.count << " rows, " << list.byteCount << " bytes";
+    if (list.overflowPageId != INVALID_PAGE_ID) os << " @page " << list.overflowPageId;
+    return os << "]";
+}
+
+inline int encodeVarint(uint64_t value, uint8_t* out) {
+    int n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+// ============ 可比较字节序键（memcomparable） ============
+// 把多列元组编码成字节串，使字节串的 memcmp 顺序与元组的字典序一致：
+//   整数：大端序，有符号数翻转符号位
+//   字符串：0x00 转义为 0x00 0xFF，以 0x00 0x01 结尾（前缀短的串排在前面）
+//   降序列：对该列编码后的每个字节取反
+// 编码定长的列后不需要分隔符，多列键的比较只需一次 memcmp
+class KeyEncoder {
+private:
+    std::string bytes;
+
+    void appendBigEndian(uint64_t value, int width, bool descending) {
+        for (int shift = (width - 1) * 8; shift >= 0; shift -= 8) {
+            uint8_t b = (uint8_t)(value >> shift);
+            bytes.push_back((char)(descending ? ~b : b));
         }
     }
-    
+
 public:
-    PagedBPlusTree(int ord = 3) : order(ord) {
-        rootPageId = bufferPool.allocatePage();
-        Page<KeyType, ValueType>* rootPage = bufferPool.fetchPage(rootPageId);
-        rootPage->header.pageType = LEAF_PAGE;
-        firstLeafPageId = rootPageId;
-        
-        std::cout << "[INIT] 创建根页面 " << rootPageId << "\n";
+    KeyEncoder& appendUint32(uint32_t value, bool descending = false) {
+        appendBigEndian(value, 4, descending);
+        return *this;
     }
-    
-    // 插入
-    void insert(KeyType key, ValueType value) {
-        std::cout << "\n[INSERT] 插入 key=" << key << "\n";
-        
-        PageID leafPageId = findLeafPage(key);
-        Page<KeyType, ValueType>* leafPage = bufferPool.fetchPage(leafPageId);
-        
-        // 检查是否已存在
-        for (int i = 0; i < (int)leafPage->header.keyCount; i++) {
-            if (leafPage->keys[i] == key) {
-                leafPage->values[i] = value;
-                bufferPool.flushPage(leafPageId);
-                return;
-            }
-        }
-        
-        if (leafPage->header.keyCount < (uint32_t)(order - 1)) {
-            int pos = 0;
-            while (pos < (int)leafPage->header.keyCount && leafPage->keys[pos] < key) pos++;
-            
-            // 移动键值
-            for (int i = leafPage->header.keyCount; i > pos; i--) {
-                leafPage->keys[i] = leafPage->keys[i - 1];
-                leafPage->values[i] = leafPage->values[i - 1];
-            }
-            
-            leafPage->keys[pos] = key;
-            leafPage->values[pos] = value;
-            leafPage->header.keyCount++;
-            
-            bufferPool.flushPage(leafPageId);
-        } else {
-            splitLeafPage(leafPageId, key, value);
+
+    KeyEncoder& appendUint64(uint64_t value, bool descending = false) {
+        appendBigEndian(value, 8, descending);
+        return *this;
+    }
+
+    KeyEncoder& appendInt32(int32_t value, bool descending = false) {
+        appendBigEndian((uint32_t)value ^ 0x80000000u, 4, descending);
+        return *this;
+    }
+
+    KeyEncoder& appendInt64(int64_t value, bool descending = false) {
+        appendBigEndian((uint64_t)value ^ 0x8000000000000000ULL, 8, descending);
+        return *this;
+    }
+
+    KeyEncoder& appendString(const std::string& value, bool descending = false) {
+        uint8_t mask = descending ? 0xFF : 0x00;
+        for (size_t i = 0; i < value.size(); i++) {
+            bytes.push_back((char)(value[i] ^ mask));
+            if (value[i] == '\0') bytes.push_back((char)(0xFF ^ mask));
         }
+        bytes.push_back((char)(0x00 ^ mask));
+        bytes.push_back((char)(0x01 ^ mask));
+        return *this;
     }
-    
-    // 查找
-    bool search(KeyType key, ValueType& value) {
-        PageID leafPageId = findLeafPage(key);
-        Page<KeyType, ValueType>* leafPage = bufferPool.fetchPage(leafPageId);
-        
-        std::cout << "[SEARCH] 在页面 " << leafPageId << " 中查找 key=" << key << "\n";
-        
-        for (int i = 0; i < (int)leafPage->header.keyCount; i++) {
-            if (leafPage->keys[i] == key) {
-                value = leafPage->values[i];
-                return true;
-            }
+
+    const std::string& data() const { return bytes; }
+    size_t size() const { return bytes.size(); }
+    void clear() { bytes.clear(); }
+};
+
+// 按编码时的列顺序逐列解码
+class KeyDecoder {
+private:
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    uint64_t readBigEndian(int width, bool descending) {
+        if (end - pos < width) throw std::out_of_range("KeyDecoder: 键字节不足");
+        uint64_t value = 0;
+        for (int i = 0; i < width; i++) {
+            uint8_t b = descending ? (uint8_t)~pos[i] : pos[i];
+            value = (value << 8) | b;
         }
-        return false;
+        pos += width;
+        return value;
     }
-    
-    // 范围查询
-    std::vector<std::pair<KeyType, ValueType> > rangeQuery(KeyType startKey, KeyType endKey) {
-        std::vector<std::pair<KeyType, ValueType> > result;
-        PageID leafPageId = findLeafPage(startKey);
-        
-        std::cout << "[RANGE] 范围查询 [" << startKey << ", " << endKey << "]\n";
-        
-        while (leafPageId != INVALID_PAGE_ID) {
-            Page<KeyType, ValueType>* leafPage = bufferPool.fetchPage(leafPageId);
-            
-            for (int i = 0; i < (int)leafPage->header.keyCount; i++) {
-                if (leafPage->keys[i] >= startKey && leafPage->keys[i] <= endKey) {
-                    result.push_back(std::make_pair(leafPage->keys[i], leafPage->values[i]));
-                }
-                if (leafPage->keys[i] > endKey) return result;
+
+public:
+    KeyDecoder(const uint8_t* data, size_t size) : pos(data), end(data + size) {}
+
+    uint32_t readUint32(bool descending = false) { return (uint32_t)readBigEndian(4, descending); }
+    uint64_t readUint64(bool descending = false) { return readBigEndian(8, descending); }
+    int32_t readInt32(bool descending = false) { return (int32_t)(readUint32(descending) ^ 0x80000000u); }
+    int64_t readInt64(bool descending = false) { return (int64_t)(readUint64(descending) ^ 0x8000000000000000ULL); }
+
+    std::string readString(bool descending = false) {
+        uint8_t mask = descending ? 0xFF : 0x00;
+        std::string value;
+        while (end - pos >= 2) {
+            uint8_t b = pos[0] ^ mask;
+            uint8_t next = pos[1] ^ mask;
+            pos++;
+            if (b != 0x00) {
+                value.push_back((char)b);
+                continue;
             }
-            
-            leafPageId = leafPage->header.nextPageId;
+            pos++;
+            if (next == 0x01) return value;   // 结束符
+            value.push_back('\0');            // 0x00 0xFF：转义的 0 字节
         }
+        throw std::out_of_range("KeyDecoder: 字符串缺少结束符");
+    }
+};
+
+// 定长的编码键，可直接作为 PagedBPlusTree 的 KeyType
+// 不足 N 字节的部分补 0：同一模式的两个完整编码在补齐之前就已分出大小，补齐不影响顺序
+template<size_t N>
+struct EncodedKey {
+    uint8_t bytes[N];
+
+    EncodedKey() : bytes() {}
+
+    explicit EncodedKey(const KeyEncoder& encoder) : bytes() {
+        if (encoder.size() > N) throw std::length_error("EncodedKey: 编码结果超过定长");
+        std::memcpy(bytes, encoder.data().data(), encoder.size());
+    }
+
+    KeyDecoder decoder() const { return KeyDecoder(bytes, N); }
+
+    bool operator<(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) < 0; }
+    bool operator>(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) > 0; }
+    bool operator<=(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) <= 0; }
+    bool operator>=(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) >= 0; }
+    bool operator==(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) == 0; }
+    bool operator!=(const EncodedKey& other) const { return std::memcmp(bytes, other.bytes, N) != 0; }
+};
+
+// EncodedKey 的比较器：memcmp 本身就是三路比较，树的页内查找每次探测只比较一次
+template<size_t N>
+struct EncodedKeyCompare {
+    bool operator()(const EncodedKey<N>& a, const EncodedKey<N>& b) const {
+        return std::memcmp(a.bytes, b.bytes, N) < 0;
+    }
+
+    int compare(const EncodedKey<N>& a, const EncodedKey<N>& b) const {
+        return std::memcmp(a.bytes, b.bytes, N);
+    }
+};
+
+// 页面落盘时以十六进制输出（省略末尾补齐的 0）
+template<size_t N>
+std::ostream& operator<<(std::ostream& os, const EncodedKey<N>& key) {
+    static const char HEX[] = "0123456789abcdef";
+    size_t len = N;
+    while (len > 0 && key.bytes[len - 1] == 0) len--;
+    for (size_t i = 0; i < len; i++) {
+        os << HEX[key.bytes[i] >> 4] << HEX[key.bytes[i] & 0xF];
+    }
+    return os;
+}
+
+namespace std {
+// 布隆过滤器按键哈希，这里对全部字节做 FNV-1a
+template<size_t N>
+struct hash<EncodedKey<N> > {
+    size_t operator()(const EncodedKey<N>& key) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (size_t i = 0; i < N; i++) {
+            h ^= key.bytes[i];
+            h *= 1099511628211ULL;
+        }
+        return (size_t)h;
+    }
+};
+}
+
+// ============ 值日志（键值分离） ============
+// 启用后不小于阈值的 std::string 值追加写入值日志，叶子槽只保存 (长度, 日志偏移)
+// 分裂、合并和刷新页面只搬移定长槽；被覆盖或删除的值成为垃圾，由树在写操作前增量回收
+// 记录格式：[u32 keyLength][u32 valueLength][key][value]，偏移单调递增，回收后丢弃日志头部
+const uint32_t VALUE_LOG_DEFAULT_THRESHOLD = 256;
+const uint64_t VALUE_LOG_NONE = ~0ULL;
+const double VALUE_LOG_GC_RATIO = 0.5;                // 垃圾占比超过此值时开始回收
+const uint64_t VALUE_LOG_GC_STEP_BYTES = 64 * 1024;   // 每次写操作前最多处理的日志字节数
+
+class ValueLog {
+private:
+    struct RecordHeader {
+        uint32_t keyLength;
+        uint32_t valueLength;
+    };
+
+    std::vector<char> buffer;   // buffer[0] 对应日志偏移 baseOffset
+    uint64_t baseOffset;
+    uint64_t headOffset;        // 回收进度：之前的记录都已处理
+    uint64_t garbageBytes;      // [head, tail) 中已失效记录的字节数
+    bool enabled;
+    uint32_t threshold;
+
+    const char* at(uint64_t offset) const {
+        return &buffer[offset - baseOffset];
+    }
+
+    RecordHeader headerAt(uint64_t offset) const {
+        RecordHeader header;
+        std::memcpy(&header, at(offset), sizeof(header));
+        return header;
+    }
+
+public:
+    ValueLog() : baseOffset(0), headOffset(0), garbageBytes(0), enabled(false),
+                 threshold(VALUE_LOG_DEFAULT_THRESHOLD) {}
+
+    void setEnabled(bool on, uint32_t minValueBytes) {
+        enabled = on;
+        threshold = minValueBytes;
+    }
+
+    // 新写入的值是否进入值日志（关闭后已在日志中的值仍可读取）
+    bool accepts(size_t valueLength) const {
+        return enabled && valueLength >= threshold;
+    }
+
+    uint64_t head() const { return headOffset; }
+    uint64_t tail() const { return baseOffset + buffer.size(); }
+    uint64_t garbage() const { return garbageBytes; }
+
+    bool needsCollection() const {
+        return garbageBytes > 0 && garbageBytes > (tail() - headOffset) * VALUE_LOG_GC_RATIO;
+    }
+
+    // 追加一条记录，返回其偏移
+    uint64_t append(const void* key, uint32_t keyLength, const char* value, uint32_t valueLength) {
+        uint64_t offset = tail();
+        RecordHeader header = {keyLength, valueLength};
+        const char* headerBytes = reinterpret_cast<const char*>(&header);
+        buffer.insert(buffer.end(), headerBytes, headerBytes + sizeof(header));
+        buffer.insert(buffer.end(), static_cast<const char*>(key), static_cast<const char*>(key) + keyLength);
+        buffer.insert(buffer.end(), value, value + valueLength);
+        return offset;
+    }
+
+    // 把 offset 处的记录原样复制到日志尾部（回收时搬移仍被引用的值）
+    uint64_t copyToTail(uint64_t offset) {
+        std::vector<char> record(at(offset), at(offset) + recordSize(offset));
+        uint64_t newOffset = tail();
+        buffer.insert(buffer.end(), record.begin(), record.end());
+        return newOffset;
+    }
+
+    size_t recordSize(uint64_t offset) const {
+        RecordHeader header = headerAt(offset);
+        return sizeof(RecordHeader) + header.keyLength + header.valueLength;
+    }
+
+    const char* keyData(uint64_t offset) const {
+        return at(offset) + sizeof(RecordHeader);
+    }
+
+    uint32_t keyLength(uint64_t offset) const {
+        return headerAt(offset).keyLength;
+    }
+
+    const char* valueData(uint64_t offset) const {
+        return keyData(offset) + headerAt(offset).keyLength;
+    }
+
+    uint32_t valueLength(uint64_t offset) const {
+        return headerAt(offset).valueLength;
+    }
+
+    // 记录对应的值被覆盖或删除
+    void markGarbage(uint64_t offset) {
+        if (offset >= headOffset) garbageBytes += recordSize(offset);
+    }
+
+    // 回收进度越过 head 处的记录；isGarbage 表示该记录已计入 garbageBytes
+    // 已处理部分超过缓冲区一半时整体丢弃，使内存占用与存活数据成正比
+    void advanceHead(bool isGarbage) {
+        size_t size = recordSize(headOffset);
+        if (isGarbage) garbageBytes -= size;
+        headOffset += size;
+        if (headOffset - baseOffset > buffer.size() / 2) {
+            buffer.erase(buffer.begin(), buffer.begin() + (headOffset - baseOffset));
+            baseOffset = headOffset;
+        }
+    }
+};
+
+// ============ 值存储 ============
+// 叶子页保存的是 ValueStorage<V>::Stored，必须可平凡复制：页面可以整块搬移、原样落盘
+// 平凡可复制的值原样存放；std::string 编码为定长槽，短值内联，长值只内联前缀、其余写入溢出页链
+// 或（启用值日志时）整体写入值日志
+// 槽位之间复制只复制槽本身，溢出链和日志记录由树在覆盖或删除值时显式释放
+template<typename ValueType>
+struct ValueStorage {
+    static_assert(std::is_trivially_copyable<ValueType>::value,
+                  "叶子值必须可平凡复制，或为其特化 ValueStorage");
+
+    typedef ValueType Stored;
+    typedef const ValueType& Reference;
+    typedef const ValueType& View;
+
+    template<typename Pool, typename KeyType>
+    static Stored encode(Pool&, ValueLog&, const KeyType&, const ValueType& value) { return value; }
+
+    template<typename Pool>
+    static Reference decode(Pool&, const ValueLog&, const Stored& stored) { return stored; }
+
+    // 不复制、不分配的只读访问
+    static View view(const ValueLog&, const Stored& stored) { return stored; }
+
+    template<typename Pool>
+    static void release(Pool&, ValueLog&, Stored&) {}
+
+    // 值日志回收：stored 引用 offset 处的记录时把记录搬到日志尾部并返回 true
+    static bool relocate(ValueLog&, Stored&, uint64_t) { return false; }
+};
+
+const int VALUE_INLINE_BYTES = 24;
+
+// std::string 值的定长槽：
+//   logOffset 有效时整个值位于值日志中，其余字段只有 length 有意义
+//   否则前 min(length, VALUE_INLINE_BYTES) 个字节存放在 inlineData，
+//   超出部分按顺序写入从 overflowPageId 开始的溢出页链（短值没有溢出链）
+// 比较前缀、判断长度不需要读取溢出页
+struct StringSlot {
+    uint32_t length;
+    PageID overflowPageId;
+    uint64_t logOffset;
+    char inlineData[VALUE_INLINE_BYTES];
+
+    StringSlot() : length(0), overflowPageId(INVALID_PAGE_ID), logOffset(VALUE_LOG_NONE), inlineData() {}
+};
+
+// 页面落盘时输出内联部分，溢出值和日志中的值附带摘要
+inline std::ostream& operator<<(std::ostream& os, const StringSlot& slot) {
+    if (slot.logOffset != VALUE_LOG_NONE) {
+        return os << "[" << slot.length << " bytes @vlog " << slot.logOffset << "]";
+    }
+    os.write(slot.inlineData, std::min<uint32_t>(slot.length, VALUE_INLINE_BYTES));
+    if (slot.overflowPageId == INVALID_PAGE_ID) return os;
+    return os << "...[" << slot.length << " bytes @page " << slot.overflowPageId << "]";
+}
+
+// std::string 值的只读视图：指向页内槽或值日志中的字节，不复制、不分配
+// 内联值和值日志中的值是连续的，可直接使用 data()/size()；
+// 溢出值只有前 VALUE_INLINE_BYTES 个字节连续（prefix()），其余需用 ValueReader 流式读取
+struct StringValueView {
+    const char* bytes;
+    uint32_t contiguousLength;
+    uint32_t length;
+
+    StringValueView(const char* b, uint32_t contiguous, uint32_t total)
+        : bytes(b), contiguousLength(contiguous), length(total) {}
+
+    uint32_t size() const { return length; }
+    bool isContiguous() const { return contiguousLength == length; }
+    const char* data() const { return bytes; }
+    uint32_t prefixLength() const { return contiguousLength; }
+
+    // 物化为 std::string（仅连续的值；溢出值只得到前缀）
+    std::string prefix() const { return std::string(bytes, contiguousLength); }
+};
+
+// 输出连续部分，溢出值附带长度摘要
+inline std::ostream& operator<<(std::ostream& os, const StringValueView& view) {
+    os.write(view.data(), view.prefixLength());
+    if (view.isContiguous()) return os;
+    return os << "...[" << view.size() << " bytes]";
+}
+
+template<>
+struct ValueStorage<std::string> {
+    typedef StringSlot Stored;
+    typedef std::string Reference;
+    typedef StringValueView View;
+
+    static View view(const ValueLog& log, const Stored& slot) {
+        if (slot.logOffset != VALUE_LOG_NONE) return View(log.valueData(slot.logOffset), slot.length, slot.length);
+        return View(slot.inlineData, std::min<uint32_t>(slot.length, VALUE_INLINE_BYTES), slot.length);
+    }
+
+    template<typename Pool, typename KeyType>
+    static Stored encode(Pool& pool, ValueLog& log, const KeyType& key, const std::string& value) {
+        Stored slot;
+        slot.length = value.size();
+        if (log.accepts(value.size()) &&
+            appendToLog(log, key, value, slot, std::is_trivially_copyable<KeyType>())) {
+            return slot;
+        }
+
+        std::memcpy(slot.inlineData, value.data(), std::min<size_t>(value.size(), VALUE_INLINE_BYTES));
+        if (value.size() <= (size_t)VALUE_INLINE_BYTES) return slot;
+
+        PageID prevPageId = INVALID_PAGE_ID;
+        for (size_t offset = VALUE_INLINE_BYTES; offset < value.size(); ) {
+            PageID pageId = pool.allocatePage();
+            OverflowPage* page = pool.newOverflowPage(pageId);
+            uint32_t chunk = std::min<size_t>(OverflowPage::CAPACITY, value.size() - offset);
+            std::memcpy(page->data, value.data() + offset, chunk);
+            page->header.keyCount = chunk;
+            offset += chunk;
+
+            if (prevPageId == INVALID_PAGE_ID) {
+                slot.overflowPageId = pageId;
+            } else {
+                pool.fetchOverflowPage(prevPageId)->header.nextPageId = pageId;
+                pool.flushPage(prevPageId);
+            }
+            prevPageId = pageId;
+        }
+        pool.flushPage(prevPageId);
+        return slot;
+    }
+
+    template<typename Pool>
+    static Reference decode(Pool& pool, const ValueLog& log, const Stored& slot) {
+        if (slot.logOffset != VALUE_LOG_NONE) return std::string(log.valueData(slot.logOffset), slot.length);
+        if (slot.overflowPageId == INVALID_PAGE_ID) return std::string(slot.inlineData, slot.length);
+
+        std::string value;
+        value.reserve(slot.length);
+        value.append(slot.inlineData, VALUE_INLINE_BYTES);
+        for (PageID pageId = slot.overflowPageId; pageId != INVALID_PAGE_ID; ) {
+            OverflowPage* page = pool.fetchOverflowPage(pageId);
+            value.append(reinterpret_cast<const char*>(page->data), page->header.keyCount);
+            pageId = page->header.nextPageId;
+        }
+        return value;
+    }
+
+    template<typename Pool>
+    static void release(Pool& pool, ValueLog& log, Stored& slot) {
+        if (slot.logOffset != VALUE_LOG_NONE) {
+            log.markGarbage(slot.logOffset);
+            slot.logOffset = VALUE_LOG_NONE;
+            return;
+        }
+        PageID pageId = slot.overflowPageId;
+        while (pageId != INVALID_PAGE_ID) {
+            PageID nextPageId = pool.fetchOverflowPage(pageId)->header.nextPageId;
+            pool.deallocatePage(pageId);
+            pageId = nextPageId;
+        }
+        slot.overflowPageId = INVALID_PAGE_ID;
+    }
+
+    // 值日志按字节保存键，键不可平凡复制时值退回槽内/溢出页存储
+    template<typename KeyType>
+    static bool appendToLog(ValueLog& log, const KeyType& key, const std::string& value, Stored& slot, std::true_type) {
+        slot.logOffset = log.append(&key, sizeof(KeyType), value.data(), value.size());
+        return true;
+    }
+
+    template<typename KeyType>
+    static bool appendToLog(ValueLog&, const KeyType&, const std::string&, Stored&, std::false_type) {
+        return false;
+    }
+
+    static bool relocate(ValueLog& log, Stored& slot, uint64_t offset) {
+        if (slot.logOffset != offset) return false;
+        slot.logOffset = log.copyToTail(offset);
+        return true;
+    }
+};
+
+// 比较器是否提供三路比较 int compare(a, b)
+template<typename C, typename K, typename = void>
+struct HasThreeWayCompare : std::false_type {};
+
+template<typename C, typename K>
+struct HasThreeWayCompare<C, K, decltype((void)std::declval<const C&>().compare(std::declval<const K&>(),
+                                                                                std::declval<const K&>()))>
+    : std::true_type {};
+
+// 叶子之间的分隔键：默认取右页首键
+// 按字典序比较的 std::string 键取 (左页末键, 右页首键] 中最短的右页首键前缀（后缀截断），
+// 内部页里的键因此更短，复制和比较都更便宜
+template<typename K, typename C>
+struct LeafSeparator {
+    static K make(const K&, const K& rightMin) { return rightMin; }
+};
+
+template<>
+struct LeafSeparator<std::string, std::less<std::string> > {
+    static std::string make(const std::string& leftMax, const std::string& rightMin) {
+        size_t n = 0;
+        while (n < leftMax.size() && n < rightMin.size() && leftMax[n] == rightMin[n]) n++;
+        return rightMin.substr(0, n + 1);
+    }
+};
+
+// ============ 页式B+树 ============
+// Compare 为键的严格弱序（默认 std::less），树内所有键比较都经过它
+// 页内二分每次探测只调用一次比较；比较器另外提供 int compare(a, b) 时，命中相等的键可提前结束
+// 启用叶子布隆过滤器时，比较器认为相等的键必须有相同的 std::hash；不启用时键类型不需要 std::hash
+template<typename KeyType, typename ValueType, typename Compare = std::less<KeyType> >
+class PagedBPlusTree {
+private:
+    typedef ValueStorage<ValueType> Storage;
+    typedef typename Storage::Stored StoredValue;   // 叶子页中实际保存的值
+    typedef typename Storage::Reference ValueRef;   // 解码出完整值时的返回类型
+    typedef typename Storage::View ValueView;       // 游标读取值时的返回类型（不复制、不分配）
+    typedef LeafPage<KeyType, StoredValue> LeafPageType;
+    typedef InternalPage<KeyType> InternalPageType;
+
+    BufferPoolManager<KeyType, StoredValue> bufferPool;
+    ValueLog valueLog;  // 键值分离模式下大值所在的日志（默认关闭）
+    PageID rootPageId;
+    PageID firstLeafPageId;
+    int maxLeafKeys;      // 叶子页最多键数
+    int maxInternalKeys;  // 内部页最多键数（孩子数为其加一）
+
+    // 结构版本号：分裂、合并、重分配时递增，缓存的下降路径据此失效
+    uint64_t structureVersion;
+
+    Compare comp;
+
+    // 按键比较键值对（批量插入排序用）
+    struct KeyLess {
+        Compare comp;
+
+        explicit KeyLess(const Compare& c) : comp(c) {}
+
+        bool operator()(const std::pair<KeyType, ValueType>& a, const std::pair<KeyType, ValueType>& b) const {
+            return comp(a.first, b.first);
+        }
+    };
+
+    bool keyLess(const KeyType& a, const KeyType& b) const {
+        return comp(a, b);
+    }
+
+    
+    // 沿最右侧孩子下降到最后一个叶子
+    PageID findLastLeafPage() {
+        PageID currentPageId = rootPageId;
+        Page* page = bufferPool.fetchPage(currentPageId);
+        while (page->header.pageType != LEAF_PAGE) {
+            currentPageId = static_cast<InternalPageType*>(page)->children[page->header.keyCount];
+            page = bufferPool.fetchPage(currentPageId);
+        }
+        return currentPageId;
+    }
+
+    // 下降路径：从根到叶子经过的内部页及在其中选择的孩子下标
+    // 分裂和合并沿此路径向上传播，页面不再保存父指针
+    struct DescentPath {
+        PageID pageIds[MAX_TREE_HEIGHT];
+        int childIndexes[MAX_TREE_HEIGHT];
+        int depth;
+
+        DescentPath() : depth(0) {}
+    };
+
+    // 最后一个叶子及其下降路径的缓存：追加插入直接定位，不再从根下降
+    // 版本号与 structureVersion 不一致时缓存失效
+    PageID lastLeafPageId;
+    DescentPath lastLeafPath;
+    uint64_t lastLeafVersion;
+
+    // 叶子提示：记住上次访问的叶子及其边界键 [lowKey, highKey)
+    // 下一个键落在边界内时直接使用该叶子，否则回退到从根下降
+    struct LeafHint {
+        PageID leafPageId;
+        DescentPath path;
+        bool hasLowKey;
+        KeyType lowKey;
+        bool hasHighKey;
+        KeyType highKey;
+        uint64_t version;
+
+        LeafHint() : leafPageId(INVALID_PAGE_ID), hasLowKey(false), lowKey(),
+                     hasHighKey(false), highKey(), version(0) {}
+    };
+    bool leafHintEnabled;
+    LeafHint leafHint;
+    uint64_t leafHintHits;
+    uint64_t leafHintMisses;
+
+    // 叶子布隆过滤器（旁路结构，按叶子页ID索引）
+    // 启用时每个叶子都有过滤器，下降过程据此识别叶子，不必读取叶子页本身
+    bool leafFiltersEnabled;
+    std::unordered_map<PageID, BloomFilter> leafFilters;
+    uint64_t filterNegatives;
+
+    // 过滤器使用的键哈希：只在键类型有 std::hash 时实例化，
+    // 否则 setLeafFiltersEnabled 无法编译，过滤器永远不会启用，另一个重载不会被调用
+    static size_t filterHash(const KeyType& key) {
+        return filterHash(key, HasStdHash<KeyType>());
+    }
+
+    static size_t filterHash(const KeyType& key, std::true_type) {
+        return std::hash<KeyType>()(key);
+    }
+
+    static size_t filterHash(const KeyType&, std::false_type) {
+        return 0;
+    }
+
+    // 按叶子当前内容重建过滤器
+    void rebuildLeafFilter(PageID leafPageId) {
+        if (!leafFiltersEnabled) return;
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        BloomFilter filter(maxLeafKeys);
+        for (uint32_t i = 0; i < leafPage->header.keyCount; i++) {
+            filter.add(filterHash(leafPage->keys[i]));
+        }
+        leafFilters[leafPageId] = filter;
+    }
+
+    void addToLeafFilter(PageID leafPageId, const KeyType& key) {
+        if (!leafFiltersEnabled) return;
+        leafFilters[leafPageId].add(filterHash(key));
+    }
+
+    void dropLeafFilter(PageID leafPageId) {
+        if (leafFiltersEnabled) leafFilters.erase(leafPageId);
+    }
+
+    // 值日志回收：从日志头部起处理约 maxBytes 字节的记录
+    // 按记录中的键回查叶子，槽仍指向该记录时把值搬到日志尾部，否则直接丢弃
+    void collectValueLog(uint64_t maxBytes) {
+        uint64_t end = std::min(valueLog.tail(), valueLog.head() + maxBytes);
+        size_t moved = 0;
+        size_t dropped = 0;
+        while (valueLog.head() < end) {
+            uint64_t offset = valueLog.head();
+            KeyType key;
+            std::memcpy(static_cast<void*>(&key), valueLog.keyData(offset), sizeof(KeyType));
+
+            PageID leafPageId = findLeafPage(key);
+            LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+            int pos = leafLowerBound(leafPage, key);
+            bool live = pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos]) &&
+                        Storage::relocate(valueLog, leafPage->values[pos], offset);
+            if (live) {
+                bufferPool.flushPage(leafPageId);
+                moved++;
+            } else {
+                dropped++;
+            }
+            valueLog.advanceHead(!live);
+        }
+        std::cout << "[VLOG] 回收: 搬移 " << moved << " 条, 丢弃 " << dropped << " 条\n";
+    }
+
+    // 写操作前的增量回收，把回收开销分摊到写入上
+    void maybeCollectValueLog() {
+        if (valueLog.needsCollection()) collectValueLog(VALUE_LOG_GC_STEP_BYTES);
+    }
+
+    // 查找叶子页面（path 非空时记录下降路径）
+    PageID findLeafPage(KeyType key, DescentPath* path = NULL) {
+        PageID currentPageId = rootPageId;
+        if (path != NULL) path->depth = 0;
+        
+        while (true) {
+            if (leafFiltersEnabled && leafFilters.find(currentPageId) != leafFilters.end()) {
+                return currentPageId;
+            }
+
+            Page* page = bufferPool.fetchPage(currentPageId);
+            
+            if (page->header.pageType == LEAF_PAGE) {
+                return currentPageId;
+            }
+            
+            // 内部节点，查找子节点
+            InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+            int pos = childIndexOf(internalPage, key);
+            if (path != NULL) {
+                path->pageIds[path->depth] = currentPageId;
+                path->childIndexes[path->depth] = pos;
+                path->depth++;
+            }
+            currentPageId = internalPage->children[pos];
+        }
+    }
+
+    // 由下降路径求叶子的上界（最深一层位于右侧的分隔键）
+    bool upperBoundOf(const DescentPath& path, KeyType& upperBound) {
+        for (int level = path.depth - 1; level >= 0; level--) {
+            InternalPageType* page = bufferPool.fetchInternalPage(path.pageIds[level]);
+            if (path.childIndexes[level] < (int)page->header.keyCount) {
+                upperBound = page->keys[path.childIndexes[level]];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 由下降路径求叶子的下界（最深一层位于左侧的分隔键）
+    bool lowerBoundOf(const DescentPath& path, KeyType& lowerBound) {
+        for (int level = path.depth - 1; level >= 0; level--) {
+            if (path.childIndexes[level] > 0) {
+                InternalPageType* page = bufferPool.fetchInternalPage(path.pageIds[level]);
+                lowerBound = page->keys[path.childIndexes[level] - 1];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 内部页中 key 所在孩子的下标：第一个大于 key 的分隔键位置（upper_bound）
+    // 扇出由页大小决定（数百个键），按二分查找而非逐个比较
+    int childIndexOf(const InternalPageType* page, const KeyType& key) const {
+        int low = 0, high = page->header.keyCount;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (keyLess(key, page->keys[mid])) high = mid;
+            else low = mid + 1;
+        }
+        return low;
+    }
+
+    // 相邻叶子之间上推到父节点的分隔键
+    static KeyType separatorOf(const LeafPageType* leftPage, const LeafPageType* rightPage) {
+        return LeafSeparator<KeyType, Compare>::make(leftPage->keys[leftPage->header.keyCount - 1], rightPage->keys[0]);
+    }
+
+    // 预取页头（键数要等页头到达后才能读出）
+    static void prefetchPage(const Page* page) {
+        PREFETCH(page);
+    }
+
+    // 预取二分查找最先访问的键 keys[n/2]、keys[n/4]、keys[3n/4]；键数组较短时整段预取
+    static void prefetchKeys(const KeyType* keys, int count) {
+        const char* begin = reinterpret_cast<const char*>(keys);
+        const char* end = reinterpret_cast<const char*>(keys + count);
+        if (end - begin <= PREFETCH_WHOLE_LINES * CACHE_LINE_SIZE) {
+            begin -= reinterpret_cast<uintptr_t>(begin) % CACHE_LINE_SIZE;
+            for (const char* addr = begin; addr < end; addr += CACHE_LINE_SIZE) PREFETCH(addr);
+            return;
+        }
+        PREFETCH(keys + count / 2);
+        PREFETCH(keys + count / 4);
+        PREFETCH(keys + 3 * count / 4);
+    }
+
+    static void prefetchSearchKeys(const Page* page) {
+        if (page->header.pageType == LEAF_PAGE) {
+            const LeafPageType* leafPage = static_cast<const LeafPageType*>(page);
+            prefetchKeys(leafPage->keys, leafPage->header.keyCount);
+        } else {
+            const InternalPageType* internalPage = static_cast<const InternalPageType*>(page);
+            prefetchKeys(internalPage->keys, internalPage->header.keyCount);
+        }
+    }
+
+    // ============ 叶子页内查找 ============
+    // 按 min/max 线性插值估计 key 的位置（仅算术类型的键）
+    static double interpolate(const KeyType* keys, int count, const KeyType& key, std::true_type) {
+        double low = (double)keys[0];
+        double high = (double)keys[count - 1];
+        return ((double)key - low) / (high - low) * (count - 1);
+    }
+
+    static double interpolate(const KeyType*, int, const KeyType&, std::false_type) {
+        return 0;
+    }
+
+    // 偏斜度：采样点上插值估计与实际下标的最大偏差（以槽位计）
+    // 插值按数值升序估计位置，只用于默认比较器
+    static bool isNearlyUniform(const KeyType* keys, int count) {
+        if (!std::is_arithmetic<KeyType>::value || !std::is_same<Compare, std::less<KeyType> >::value ||
+            count < INTERPOLATION_MIN_KEYS) {
+            return false;
+        }
+        int maxError = 0;
+        for (int s = 1; s < INTERPOLATION_SAMPLES; s++) {
+            int i = (int)((long long)s * (count - 1) / INTERPOLATION_SAMPLES);
+            int guess = (int)interpolate(keys, count, keys[i], std::is_arithmetic<KeyType>());
+            maxError = std::max(maxError, std::abs(guess - i));
+        }
+        return maxError <= count / INTERPOLATION_SAMPLES;
+    }
+
+    // 叶子内容变化后重新选择页内查找方式（只看固定个采样点，开销为常数）
+    void updateSearchMode(PageID leafPageId) {
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        leafPage->header.interpolationSearch = isNearlyUniform(leafPage->keys, leafPage->header.keyCount) ? 1 : 0;
+    }
+
+    // 分裂、合并或重分配改变了叶子的键集合：重新选择页内查找方式、重建过滤器并落盘
+    void refreshLeafPage(PageID leafPageId) {
+        updateSearchMode(leafPageId);
+        rebuildLeafFilter(leafPageId);
+        bufferPool.flushPage(leafPageId);
+    }
+
+    // keys[low, high) 中第一个 >= key 的位置，每次探测调用一次比较器
+    int lowerBoundIn(const KeyType* keys, int low, int high, const KeyType& key) const {
+        return lowerBoundIn(keys, low, high, key, HasThreeWayCompare<Compare, KeyType>());
+    }
+
+    // 比较器自带 compare：叶子内键唯一，三路比较命中相等时即可提前返回
+    int lowerBoundIn(const KeyType* keys, int low, int high, const KeyType& key, std::true_type) const {
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            int c = comp.compare(keys[mid], key);
+            if (c == 0) return mid;
+            if (c < 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    // 只有 operator()：用它模拟三路比较每次探测要调用两次，这里按普通 lower_bound 二分
+    int lowerBoundIn(const KeyType* keys, int low, int high, const KeyType& key, std::false_type) const {
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (comp(keys[mid], key)) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    // 叶子内第一个 >= key 的位置
+    // 插值页：从估计位置出发做指数搜索找到包含 key 的区间，再在区间内二分；其余页直接二分
+    int leafLowerBound(const LeafPageType* leafPage, const KeyType& key) const {
+        const KeyType* keys = leafPage->keys;
+        int count = leafPage->header.keyCount;
+        if (!leafPage->header.interpolationSearch || count < 2 || keyLess(key, keys[0]) || keyLess(keys[count - 1], key)) {
+            return lowerBoundIn(keys, 0, count, key);
+        }
+
+        int guess = (int)interpolate(keys, count, key, std::is_arithmetic<KeyType>());
+        guess = std::max(0, std::min(count - 1, guess));
+        int low, high;  // 结果位于 (low, high]
+        if (keyLess(keys[guess], key)) {
+            int step = 1;
+            low = guess;
+            high = guess + step;
+            while (high < count && keyLess(keys[high], key)) {
+                low = high;
+                step *= 2;
+                high = guess + step;
+            }
+            high = std::min(high, count);
+        } else {
+            int step = 1;
+            high = guess;
+            low = guess - step;
+            while (low >= 0 && !keyLess(keys[low], key)) {
+                high = low;
+                step *= 2;
+                low = guess - step;
+            }
+            low = std::max(low, -1);
+        }
+        return lowerBoundIn(keys, low + 1, high, key);
+    }
+
+    // 小于 key（inclusive 时为不大于 key）的条目数：下降时累加所选孩子左侧的子树计数
+    SubtreeCount countBefore(const KeyType& key, bool inclusive) {
+        SubtreeCount before = 0;
+        Page* page = bufferPool.fetchPage(rootPageId);
+        while (page->header.pageType != LEAF_PAGE) {
+            InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+            int pos = 0;
+            while (pos < (int)internalPage->header.keyCount && !keyLess(key, internalPage->keys[pos])) {
+                before += internalPage->counts[pos];
+                pos++;
+            }
+            page = bufferPool.fetchPage(internalPage->children[pos]);
+        }
+        LeafPageType* leafPage = static_cast<LeafPageType*>(page);
+        int pos = leafLowerBound(leafPage, key);
+        if (inclusive && pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos])) pos++;
+        return before + pos;
+    }
+
+    // 定位 key 所在叶子：启用提示且 key 在上次叶子的边界内时跳过下降
+    PageID locateLeafPage(const KeyType& key, DescentPath* path = NULL) {
+        if (!leafHintEnabled) return findLeafPage(key, path);
+
+        LeafHint& hint = leafHint;
+        if (hint.leafPageId != INVALID_PAGE_ID && hint.version == structureVersion &&
+            (!hint.hasLowKey || !keyLess(key, hint.lowKey)) && (!hint.hasHighKey || keyLess(key, hint.highKey))) {
+            leafHintHits++;
+            if (path != NULL) *path = hint.path;
+            return hint.leafPageId;
+        }
+
+        leafHintMisses++;
+        hint.leafPageId = findLeafPage(key, &hint.path);
+        hint.hasLowKey = lowerBoundOf(hint.path, hint.lowKey);
+        hint.hasHighKey = upperBoundOf(hint.path, hint.highKey);
+        hint.version = structureVersion;
+        if (path != NULL) *path = hint.path;
+        return hint.leafPageId;
+    }
+
+    // 路径上每一层都选择了最右孩子（即路径通向最后一个叶子）
+    bool isRightmostPath(const DescentPath& path) {
+        for (int level = 0; level < path.depth; level++) {
+            InternalPageType* page = bufferPool.fetchInternalPage(path.pageIds[level]);
+            if (path.childIndexes[level] != (int)page->header.keyCount) return false;
+        }
+        return true;
+    }
+
+    // 子树中的条目数：叶子为键数，内部页为各孩子计数之和
+    SubtreeCount subtreeSize(PageID pageId) {
+        Page* page = bufferPool.fetchPage(pageId);
+        if (page->header.pageType == LEAF_PAGE) return page->header.keyCount;
+        InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+        SubtreeCount total = 0;
+        for (uint32_t i = 0; i <= internalPage->header.keyCount; i++) total += internalPage->counts[i];
+        return total;
+    }
+
+    // 叶子增减 delta 个条目后，沿下降路径修正各层所选孩子的子树计数
+    // 祖先页只标记为脏页，不逐个同步落盘：每次写入都会改到整条路径，同步刷新会抵消追加快速路径省下的下降
+    void adjustPathCounts(const DescentPath& path, long long delta) {
+        for (int level = 0; level < path.depth; level++) {
+            InternalPageType* page = bufferPool.fetchInternalPage(path.pageIds[level]);
+            page->counts[path.childIndexes[level]] += delta;
+            bufferPool.markDirty(path.pageIds[level]);
+        }
+    }
+
+    // 追加模式下的分片大小：前面的页装满，最后一页至少 minLast 个
+    // 普通模式下均分（每页至少半满）
+    static int pieceSize(int total, int pieces, int p, int maxPerPiece, int minLast, bool append) {
+        if (!append) return total / pieces + (p < total % pieces ? 1 : 0);
+        int last = total - (pieces - 1) * maxPerPiece;
+        int borrowed = last < minLast ? minLast - last : 0;
+        if (p == pieces - 1) return last + borrowed;
+        if (p == pieces - 2) return maxPerPiece - borrowed;
+        return maxPerPiece;
+    }
+
+    // 以 leftPageId 与 rightPageId 为孩子创建新根
+    void createNewRoot(PageID leftPageId, KeyType key, PageID rightPageId) {
+        PageID newRootPageId = bufferPool.allocatePage();
+        InternalPageType* newRootPage = bufferPool.newInternalPage(newRootPageId);
+        newRootPage->header.keyCount = 1;
+        newRootPage->keys[0] = key;
+        newRootPage->children[0] = leftPageId;
+        newRootPage->children[1] = rightPageId;
+        newRootPage->counts[0] = subtreeSize(leftPageId);
+        newRootPage->counts[1] = subtreeSize(rightPageId);
+        rootPageId = newRootPageId;
+
+        std::cout << "[ROOT] 创建新根页面 " << newRootPageId << "\n";
+    }
+    
+    // 分裂叶子页面
+    // 就地分裂：按合并后的虚拟序列（原有键 + 新键）确定分裂点，
+    // 每个条目只移动一次，直接落到目标页，不经过临时数组
+    // 在最后一个叶子的末尾追加时（自增 id、时间戳）左页保持满，新键单独进入右页
+    void splitLeafPage(PageID leafPageId, KeyType key, StoredValue value, DescentPath& path) {
+        structureVersion++;
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        PageID newLeafPageId = bufferPool.allocatePage();
+        LeafPageType* newLeafPage = bufferPool.newLeafPage(newLeafPageId);
+        
+        int count = leafPage->header.keyCount;
+        KeyType* keys = leafPage->keys;
+        StoredValue* values = leafPage->values;
+        
+        // 新键的插入位置
+        int pos = leafLowerBound(leafPage, key);
+        
+        // 分裂点：左页保留虚拟序列的前 mid 个条目
+        bool append = pos == count && leafPage->header.nextPageId == INVALID_PAGE_ID;
+        int mid = append ? count : (maxLeafKeys + 2) / 2;
+        
+        std::cout << "[SPLIT] " << (append ? "追加分裂" : "分裂") << "叶子页面 "
+                  << leafPageId << " -> " << newLeafPageId << "\n";
+        
+        if (pos < mid) {
+            // 新键落在左页：原 [mid-1, count) 移到右页，左页腾出 pos 位置
+            moveRange(keys + mid - 1, keys + count, newLeafPage->keys);
+            moveRange(values + mid - 1, values + count, newLeafPage->values);
+            moveRange(keys + pos, keys + mid - 1, keys + pos + 1);
+            moveRange(values + pos, values + mid - 1, values + pos + 1);
+            keys[pos] = std::move(key);
+            values[pos] = std::move(value);
+        } else {
+            // 新键落在右页：原 [mid, pos) + 新键 + 原 [pos, count)
+            int rightPos = pos - mid;
+            moveRange(keys + mid, keys + pos, newLeafPage->keys);
+            moveRange(values + mid, values + pos, newLeafPage->values);
+            newLeafPage->keys[rightPos] = std::move(key);
+            newLeafPage->values[rightPos] = std::move(value);
+            moveRange(keys + pos, keys + count, newLeafPage->keys + rightPos + 1);
+            moveRange(values + pos, values + count, newLeafPage->values + rightPos + 1);
+        }
+        leafPage->header.keyCount = mid;
+        newLeafPage->header.keyCount = count + 1 - mid;
+        
+        // 更新链表指针
+        newLeafPage->header.nextPageId = leafPage->header.nextPageId;
+        newLeafPage->header.prevPageId = leafPageId;
+        if (leafPage->header.nextPageId != INVALID_PAGE_ID) {
+            LeafPageType* nextPage = bufferPool.fetchLeafPage(leafPage->header.nextPageId);
+            nextPage->header.prevPageId = newLeafPageId;
+        }
+        leafPage->header.nextPageId = newLeafPageId;
+        
+        // 向父节点插入
+        if (path.depth == 0) {
+            createNewRoot(leafPageId, separatorOf(leafPage, newLeafPage), newLeafPageId);
+        } else {
+            insertInternal(path, separatorOf(leafPage, newLeafPage), newLeafPageId);
+        }
+        
+        refreshLeafPage(leafPageId);
+        refreshLeafPage(newLeafPageId);
+    }
+    
+    // 分裂内部页面
+    // pos 为新键在该页中的插入位置（来自下降路径）
+    // 与叶子分裂相同，按虚拟序列就地分裂：键 count+1 个、孩子 count+2 个
+    void splitInternalPage(PageID internalPageId, int pos, KeyType key, PageID childPageId, DescentPath& path) {
+        InternalPageType* internalPage = bufferPool.fetchInternalPage(internalPageId);
+        PageID newInternalPageId = bufferPool.allocatePage();
+        InternalPageType* newInternalPage = bufferPool.newInternalPage(newInternalPageId);
+        
+        int count = internalPage->header.keyCount;
+        KeyType* keys = internalPage->keys;
+        PageID* children = internalPage->children;
+        SubtreeCount* counts = internalPage->counts;
+        KeyType* rightKeys = newInternalPage->keys;
+        PageID* rightChildren = newInternalPage->children;
+        SubtreeCount* rightCounts = newInternalPage->counts;
+        
+        // 子树计数与孩子一起移动：先更新分裂过的左孩子，新孩子按其实际大小插入
+        counts[pos] = subtreeSize(children[pos]);
+        SubtreeCount childCount = subtreeSize(childPageId);
+        
+        // 分裂点（上推一个键后左右两侧都不少于 minInternalKeys() 个键）
+        // 最右内部页末尾追加时左页只让出最后一个键，右页从一个键开始增长
+        bool append = pos == count && isRightmostPath(path);
+        int mid = append ? count - 1 : (maxInternalKeys + 1) / 2;
+        
+        std::cout << "[SPLIT] " << (append ? "追加分裂" : "分裂") << "内部页面 "
+                  << internalPageId << " -> " << newInternalPageId << "\n";
+        KeyType midKey;
+        
+        if (pos < mid) {
+            // 新键落在左页，上推原 keys[mid-1]
+            midKey = std::move(keys[mid - 1]);
+            moveRange(keys + mid, keys + count, rightKeys);
+            moveRange(children + mid, children + count + 1, rightChildren);
+            moveRange(counts + mid, counts + count + 1, rightCounts);
+            moveRange(keys + pos, keys + mid - 1, keys + pos + 1);
+            moveRange(children + pos + 1, children + mid, children + pos + 2);
+            moveRange(counts + pos + 1, counts + mid, counts + pos + 2);
+            keys[pos] = std::move(key);
+            children[pos + 1] = childPageId;
+            counts[pos + 1] = childCount;
+        } else if (pos == mid) {
+            // 新键本身上推，新孩子成为右页最左孩子
+            midKey = std::move(key);
+            moveRange(keys + mid, keys + count, rightKeys);
+            rightChildren[0] = childPageId;
+            rightCounts[0] = childCount;
+            moveRange(children + mid + 1, children + count + 1, rightChildren + 1);
+            moveRange(counts + mid + 1, counts + count + 1, rightCounts + 1);
+        } else {
+            // 新键落在右页，上推原 keys[mid]
+            int rightPos = pos - mid - 1;
+            midKey = std::move(keys[mid]);
+            moveRange(keys + mid + 1, keys + pos, rightKeys);
+            rightKeys[rightPos] = std::move(key);
+            moveRange(keys + pos, keys + count, rightKeys + rightPos + 1);
+            moveRange(children + mid + 1, children + pos + 1, rightChildren);
+            moveRange(counts + mid + 1, counts + pos + 1, rightCounts);
+            rightChildren[rightPos + 1] = childPageId;
+            rightCounts[rightPos + 1] = childCount;
+            moveRange(children + pos + 1, children + count + 1, rightChildren + rightPos + 2);
+            moveRange(counts + pos + 1, counts + count + 1, rightCounts + rightPos + 2);
+        }
+        internalPage->header.keyCount = mid;
+        newInternalPage->header.keyCount = count - mid;
+        
+        // 向父节点插入
+        if (path.depth == 0) {
+            createNewRoot(internalPageId, midKey, newInternalPageId);
+        } else {
+            insertInternal(path, midKey, newInternalPageId);
+        }
+        
+        bufferPool.flushPage(internalPageId);
+        bufferPool.flushPage(newInternalPageId);
+    }
+    
+    // 向下降路径上最深的内部节点插入（分裂出的新页位于路径所选孩子的右侧）
+    void insertInternal(DescentPath& path, KeyType key, PageID childPageId) {
+        path.depth--;
+        PageID internalPageId = path.pageIds[path.depth];
+        int pos = path.childIndexes[path.depth];
+        InternalPageType* internalPage = bufferPool.fetchInternalPage(internalPageId);
+        
+        if ((int)internalPage->header.keyCount < maxInternalKeys) {
+            // 移动键和子节点
+            int count = internalPage->header.keyCount;
+            moveRange(internalPage->keys + pos, internalPage->keys + count, internalPage->keys + pos + 1);
+            moveRange(internalPage->children + pos + 1, internalPage->children + count + 1, internalPage->children + pos + 2);
+            moveRange(internalPage->counts + pos + 1, internalPage->counts + count + 1, internalPage->counts + pos + 2);
+            
+            internalPage->keys[pos] = key;
+            internalPage->children[pos + 1] = childPageId;
+            internalPage->counts[pos] = subtreeSize(internalPage->children[pos]);
+            internalPage->counts[pos + 1] = subtreeSize(childPageId);
+            internalPage->header.keyCount++;
+            
+            bufferPool.flushPage(internalPageId);
+        } else {
+            splitInternalPage(internalPageId, pos, key, childPageId, path);
+        }
+    }
+
+    // 将 leftPageId 右侧新产生的若干兄弟页一次性插入父节点（下降路径最深一层）
+    // sepKeys[i] 是 newPageIds[i] 的分隔键，新页按键序排列在 leftPageId 之后
+    // 与叶子归并相同，按虚拟序列（原有孩子 + 新页）就地放置，必要时一次性多路分裂
+    void insertIntoParentBatch(DescentPath& path, PageID leftPageId, const std::vector<KeyType>& sepKeys,
+                               const std::vector<PageID>& newPageIds) {
+        PageID parentPageId;
+        int childIdx;
+        if (path.depth == 0) {
+            // 创建只有一个孩子的新根，随后按普通父节点处理
+            parentPageId = bufferPool.allocatePage();
+            InternalPageType* newRootPage = bufferPool.newInternalPage(parentPageId);
+            newRootPage->header.keyCount = 0;
+            newRootPage->children[0] = leftPageId;
+            rootPageId = parentPageId;
+            childIdx = 0;
+
+            std::cout << "[ROOT] 创建新根页面 " << parentPageId << "\n";
+        } else {
+            path.depth--;
+            parentPageId = path.pageIds[path.depth];
+            childIdx = path.childIndexes[path.depth];
+        }
+
+        InternalPageType* parentPage = bufferPool.fetchInternalPage(parentPageId);
+        KeyType* keys = parentPage->keys;
+        PageID* children = parentPage->children;
+        SubtreeCount* counts = parentPage->counts;
+        int count = parentPage->header.keyCount;
+        int added = newPageIds.size();
+        counts[childIdx] = subtreeSize(leftPageId);
+
+        // 新页挂在最右内部页末尾时按追加模式分片
+        bool append = childIdx == count && isRightmostPath(path);
+
+        // 虚拟序列：孩子为原 [0, childIdx] + 新页 + 原 (childIdx, count]，
+        // 键为原 [0, childIdx) + 分隔键 + 原 [childIdx, count)，虚拟键 g 位于虚拟孩子 g 与 g+1 之间
+        // 子节点分到 pieces 个页面（第 0 片为父节点本身），页面之间的键上推
+        int totalChildren = count + 1 + added;
+        int maxChildren = maxInternalKeys + 1;
+        int pieces = (totalChildren + maxChildren - 1) / maxChildren;
+        std::vector<InternalPageType*> piecePages(1, parentPage);
+        std::vector<int> pieceBegins(1, 0);
+        std::vector<KeyType> upKeys(pieces - 1);
+        std::vector<PageID> upPageIds;
+
+        if (pieces > 1) {
+            std::cout << "[SPLIT] 多路分裂内部页面 " << parentPageId << " 为 " << pieces << " 个页面\n";
+        }
+        for (int p = 1; p < pieces; p++) {
+            pieceBegins.push_back(pieceBegins.back() + pieceSize(totalChildren, pieces, p - 1, maxChildren, 2, append));
+            PageID pieceId = bufferPool.allocatePage();
+            upPageIds.push_back(pieceId);
+            piecePages.push_back(bufferPool.newInternalPage(pieceId));
+        }
+        pieceBegins.push_back(totalChildren);
+
+        // 从尾部向前放置每个孩子及其右侧的键：原有元素的读取位置不超过 g，
+        // 第 0 片的写入位置为 g，不会覆盖尚未读取的元素；每个元素只移动一次
+        int p = pieces - 1;
+        for (int g = totalChildren - 1; g >= 0; g--) {
+            while (g < pieceBegins[p]) p--;
+            if (p == 0 && g < childIdx && g + 1 < pieceBegins[1]) break;  // 其余原有元素已在最终位置
+
+            InternalPageType* piece = piecePages[p];
+            int slot = g - pieceBegins[p];
+            if (g < totalChildren - 1) {
+                KeyType* dest = g + 1 < pieceBegins[p + 1] ? &piece->keys[slot] : &upKeys[p];
+                if (g >= childIdx + added) {
+                    *dest = std::move(keys[g - added]);
+                } else if (g >= childIdx) {
+                    *dest = sepKeys[g - childIdx];
+                } else {
+                    *dest = std::move(keys[g]);
+                }
+            }
+            if (g > childIdx + added) {
+                piece->children[slot] = children[g - added];
+                piece->counts[slot] = counts[g - added];
+            } else if (g > childIdx) {
+                piece->children[slot] = newPageIds[g - childIdx - 1];
+                piece->counts[slot] = subtreeSize(newPageIds[g - childIdx - 1]);
+            } else if (p > 0) {
+                piece->children[slot] = children[g];
+                piece->counts[slot] = counts[g];
+            }
+        }
+        for (int q = 0; q < pieces; q++) {
+            piecePages[q]->header.keyCount = pieceBegins[q + 1] - pieceBegins[q] - 1;
+        }
+
+        if (pieces == 1) {
+            bufferPool.flushPage(parentPageId);
+            return;
+        }
+
+        // 先把新页挂到父节点，再落盘
+        insertIntoParentBatch(path, parentPageId, upKeys, upPageIds);
+        bufferPool.flushPage(parentPageId);
+        for (size_t i = 0; i < upPageIds.size(); i++) {
+            bufferPool.flushPage(upPageIds[i]);
+        }
+    }
+
+    // 将已排序的 entries[begin, end) 一次归并进叶子页面，必要时一次性多路分裂
+    // 就地归并：先数出归并后的条目数并确定分片，再从尾部向前把条目直接放到所在页的最终位置
+    // （与数组尾部归并相同，写入位置始终不小于尚未读取的原有条目），不经过临时数组
+    void mergeIntoLeaf(PageID leafPageId, DescentPath& path,
+                       const std::vector<std::pair<KeyType, ValueType> >& entries, size_t begin, size_t end) {
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        KeyType* keys = leafPage->keys;
+        StoredValue* values = leafPage->values;
+        int count = leafPage->header.keyCount;
+
+        // 新键全部追加在最后一个叶子末尾
+        bool append = leafPage->header.nextPageId == INVALID_PAGE_ID &&
+                      (count == 0 || keyLess(keys[count - 1], entries[begin].first));
+
+        // 归并后的条目数：键相同时以新值覆盖，不增加条目
+        int total = count;
+        for (int i = 0, j = begin; j < (int)end; j++) {
+            while (i < count && keyLess(keys[i], entries[j].first)) i++;
+            if (i < count && !keyLess(entries[j].first, keys[i])) {
+                i++;
+            } else {
+                total++;
+            }
+        }
+
+        adjustPathCounts(path, total - count);
+
+        // 分片：第 0 片为原叶子，放不下时均分到 pieces 个页面，保证每页至少半满；追加模式下前面的页装满
+        int maxKeys = maxLeafKeys;
+        int pieces = (total + maxKeys - 1) / maxKeys;
+        std::vector<LeafPageType*> piecePages(1, leafPage);
+        std::vector<int> pieceBegins(1, 0);
+        std::vector<PageID> newPageIds;
+
+        if (pieces > 1) {
+            structureVersion++;
+            std::cout << "[SPLIT] 多路分裂叶子页面 " << leafPageId << " 为 " << pieces << " 个页面\n";
+        }
+        for (int p = 1; p < pieces; p++) {
+            pieceBegins.push_back(pieceBegins.back() + pieceSize(total, pieces, p - 1, maxKeys, 1, append));
+            PageID pieceId = bufferPool.allocatePage();
+            newPageIds.push_back(pieceId);
+            piecePages.push_back(bufferPool.newLeafPage(pieceId));
+        }
+        pieceBegins.push_back(total);
+
+        int i = count - 1;
+        size_t j = end;
+        int p = pieces - 1;
+        for (int g = total - 1; g >= 0; g--) {
+            while (g < pieceBegins[p]) p--;
+            if (p == 0 && j == begin) break;  // 只剩原有条目，已在最终位置
+
+            LeafPageType* piece = piecePages[p];
+            int slot = g - pieceBegins[p];
+            if (j > begin && (i < 0 || !keyLess(entries[j - 1].first, keys[i]))) {
+                // 新条目；与原有键相同时释放旧值
+                j--;
+                if (i >= 0 && !keyLess(keys[i], entries[j].first)) {
+                    Storage::release(bufferPool, valueLog, values[i]);
+                    i--;
+                }
+                piece->keys[slot] = entries[j].first;
+                piece->values[slot] = Storage::encode(bufferPool, valueLog, entries[j].first, entries[j].second);
+            } else {
+                if (p > 0 || slot != i) {
+                    piece->keys[slot] = std::move(keys[i]);
+                    piece->values[slot] = std::move(values[i]);
+                }
+                i--;
+            }
+        }
+        for (int q = 0; q < pieces; q++) {
+            piecePages[q]->header.keyCount = pieceBegins[q + 1] - pieceBegins[q];
+        }
+
+        if (pieces == 1) {
+            for (size_t k = begin; k < end; k++) addToLeafFilter(leafPageId, entries[k].first);
+            updateSearchMode(leafPageId);
+            bufferPool.flushPage(leafPageId);
+            return;
+        }
+
+        // 链接新页并更新链表尾部
+        PageID prevPageId = leafPageId;
+        PageID oldNextPageId = leafPage->header.nextPageId;
+        std::vector<KeyType> sepKeys;
+        for (int q = 1; q < pieces; q++) {
+            piecePages[q]->header.prevPageId = prevPageId;
+            piecePages[q - 1]->header.nextPageId = newPageIds[q - 1];
+            sepKeys.push_back(separatorOf(piecePages[q - 1], piecePages[q]));
+            prevPageId = newPageIds[q - 1];
+        }
+        piecePages[pieces - 1]->header.nextPageId = oldNextPageId;
+        if (oldNextPageId != INVALID_PAGE_ID) {
+            bufferPool.fetchPage(oldNextPageId)->header.prevPageId = prevPageId;
+        }
+
+        insertIntoParentBatch(path, leafPageId, sepKeys, newPageIds);
+
+        refreshLeafPage(leafPageId);
+        for (size_t k = 0; k < newPageIds.size(); k++) {
+            refreshLeafPage(newPageIds[k]);
+        }
+    }
+
+    // 下溢阈值：约为容量的一半（与分裂后两侧的最少键数一致）
+    int minLeafKeys() const { return (maxLeafKeys + 1) / 2; }
+    int minInternalKeys() const { return maxInternalKeys / 2; }
+
+    // 从下降路径最深一层的内部节点删除 keys[keyIdx] 及其右侧子节点 children[keyIdx + 1]
+    void removeFromInternal(DescentPath& path, int keyIdx) {
+        path.depth--;
+        PageID internalPageId = path.pageIds[path.depth];
+        InternalPageType* internalPage = bufferPool.fetchInternalPage(internalPageId);
+
+        int count = internalPage->header.keyCount;
+        moveRange(internalPage->keys + keyIdx + 1, internalPage->keys + count, internalPage->keys + keyIdx);
+        moveRange(internalPage->children + keyIdx + 2, internalPage->children + count + 1, internalPage->children + keyIdx + 1);
+        moveRange(internalPage->counts + keyIdx + 2, internalPage->counts + count + 1, internalPage->counts + keyIdx + 1);
+        internalPage->header.keyCount--;
+
+        if (path.depth == 0) {
+            // 根节点只剩一个孩子时树高减一
+            if (internalPage->header.keyCount == 0) {
+                PageID newRootPageId = internalPage->children[0];
+                bufferPool.deallocatePage(internalPageId);
+                rootPageId = newRootPageId;
+
+                std::cout << "[ROOT] 根页面收缩为 " << newRootPageId << "\n";
+            } else {
+                bufferPool.flushPage(internalPageId);
+            }
+            return;
+        }
+
+        if ((int)internalPage->header.keyCount >= minInternalKeys()) {
+            bufferPool.flushPage(internalPageId);
+            return;
+        }
+
+        // 下溢：与左兄弟（没有则右兄弟）合并或重分配
+        InternalPageType* parentPage = bufferPool.fetchInternalPage(path.pageIds[path.depth - 1]);
+        int idx = path.childIndexes[path.depth - 1];
+        if (idx > 0) {
+            rebalanceInternal(path, parentPage->children[idx - 1], internalPageId, idx - 1);
+        } else {
+            rebalanceInternal(path, internalPageId, parentPage->children[1], 0);
+        }
+    }
+
+    // 相邻内部节点（父节点为路径最深一层，分隔键为 keys[sepIdx]）：放得下则合并，否则经父节点均分
+    void rebalanceInternal(DescentPath& path, PageID leftPageId, PageID rightPageId, int sepIdx) {
+        PageID parentPageId = path.pageIds[path.depth - 1];
+        InternalPageType* leftPage = bufferPool.fetchInternalPage(leftPageId);
+        InternalPageType* rightPage = bufferPool.fetchInternalPage(rightPageId);
+        InternalPageType* parentPage = bufferPool.fetchInternalPage(parentPageId);
+
+        int leftKeys = leftPage->header.keyCount;
+        int rightKeys = rightPage->header.keyCount;
+        int totalKeys = leftKeys + 1 + rightKeys;  // 左键 + 分隔键 + 右键
+
+        if (totalKeys <= maxInternalKeys) {
+            std::cout << "[MERGE] 合并内部页面 " << rightPageId << " -> " << leftPageId << "\n";
+
+            // 分隔键下移到左页末尾，右页键/子节点/计数整体接在其后
+            leftPage->keys[leftKeys] = std::move(parentPage->keys[sepIdx]);
+            moveRange(rightPage->keys, rightPage->keys + rightKeys, leftPage->keys + leftKeys + 1);
+            moveRange(rightPage->children, rightPage->children + rightKeys + 1, leftPage->children + leftKeys + 1);
+            moveRange(rightPage->counts, rightPage->counts + rightKeys + 1, leftPage->counts + leftKeys + 1);
+            leftPage->header.keyCount = totalKeys;
+            parentPage->counts[sepIdx] += parentPage->counts[sepIdx + 1];
+            bufferPool.deallocatePage(rightPageId);
+            bufferPool.flushPage(leftPageId);
+            removeFromInternal(path, sepIdx);
+            return;
+        }
+
+        std::cout << "[REDISTRIBUTE] 重分配内部页面 " << leftPageId << " / " << rightPageId << "\n";
+
+        // 经父节点旋转：分隔键下移到接收方，发送方边界键上移为新分隔键
+        int leftCount = totalKeys / 2;
+        if (leftCount > leftKeys) {
+            int moved = leftCount - leftKeys;
+            leftPage->keys[leftKeys] = std::move(parentPage->keys[sepIdx]);
+            moveRange(rightPage->keys, rightPage->keys + moved - 1, leftPage->keys + leftKeys + 1);
+            parentPage->keys[sepIdx] = std::move(rightPage->keys[moved - 1]);
+            moveRange(rightPage->children, rightPage->children + moved, leftPage->children + leftKeys + 1);
+            moveRange(rightPage->counts, rightPage->counts + moved, leftPage->counts + leftKeys + 1);
+
+            moveRange(rightPage->keys + moved, rightPage->keys + rightKeys, rightPage->keys);
+            moveRange(rightPage->children + moved, rightPage->children + rightKeys + 1, rightPage->children);
+            moveRange(rightPage->counts + moved, rightPage->counts + rightKeys + 1, rightPage->counts);
+        } else if (leftCount < leftKeys) {
+            int moved = leftKeys - leftCount;
+            moveRange(rightPage->keys, rightPage->keys + rightKeys, rightPage->keys + moved);
+            moveRange(rightPage->children, rightPage->children + rightKeys + 1, rightPage->children + moved);
+            moveRange(rightPage->counts, rightPage->counts + rightKeys + 1, rightPage->counts + moved);
+
+            rightPage->keys[moved - 1] = std::move(parentPage->keys[sepIdx]);
+            moveRange(leftPage->keys + leftCount + 1, leftPage->keys + leftKeys, rightPage->keys);
+            moveRange(leftPage->children + leftCount + 1, leftPage->children + leftKeys + 1, rightPage->children);
+            moveRange(leftPage->counts + leftCount + 1, leftPage->counts + leftKeys + 1, rightPage->counts);
+            parentPage->keys[sepIdx] = std::move(leftPage->keys[leftCount]);
+        }
+        leftPage->header.keyCount = leftCount;
+        rightPage->header.keyCount = totalKeys - leftCount - 1;
+        parentPage->counts[sepIdx] = subtreeSize(leftPageId);
+        parentPage->counts[sepIdx + 1] = subtreeSize(rightPageId);
+
+        bufferPool.flushPage(leftPageId);
+        bufferPool.flushPage(rightPageId);
+        bufferPool.flushPage(parentPageId);
+    }
+
+    // 相邻叶子（父节点为路径最深一层，分隔键为 keys[sepIdx]）：放得下则合并，否则均分
+    void rebalanceLeaves(DescentPath& path, PageID leftPageId, PageID rightPageId, int sepIdx) {
+        structureVersion++;
+        PageID parentPageId = path.pageIds[path.depth - 1];
+        LeafPageType* leftPage = bufferPool.fetchLeafPage(leftPageId);
+        LeafPageType* rightPage = bufferPool.fetchLeafPage(rightPageId);
+        InternalPageType* parentPage = bufferPool.fetchInternalPage(parentPageId);
+
+        int total = leftPage->header.keyCount + rightPage->header.keyCount;
+
+        if (total <= maxLeafKeys) {
+            std::cout << "[MERGE] 合并叶子页面 " << rightPageId << " -> " << leftPageId << "\n";
+
+            std::copy(rightPage->keys, rightPage->keys + rightPage->header.keyCount,
+                      leftPage->keys + leftPage->header.keyCount);
+            std::copy(rightPage->values, rightPage->values + rightPage->header.keyCount,
+                      leftPage->values + leftPage->header.keyCount);
+            leftPage->header.keyCount = total;
+            parentPage->counts[sepIdx] = total;
+
+            // 更新链表指针
+            leftPage->header.nextPageId = rightPage->header.nextPageId;
+            if (rightPage->header.nextPageId != INVALID_PAGE_ID) {
+                LeafPageType* nextPage = bufferPool.fetchLeafPage(rightPage->header.nextPageId);
+                nextPage->header.prevPageId = leftPageId;
+            }
+
+            dropLeafFilter(rightPageId);
+            bufferPool.deallocatePage(rightPageId);
+            refreshLeafPage(leftPageId);
+            removeFromInternal(path, sepIdx);
+            return;
+        }
+
+        std::cout << "[REDISTRIBUTE] 重分配叶子页面 " << leftPageId << " / " << rightPageId << "\n";
+
+        int leftCount = total / 2;
+        int leftKeyCount = leftPage->header.keyCount;
+        int rightKeyCount = rightPage->header.keyCount;
+        if (leftKeyCount > leftCount) {
+            // 左 -> 右：右侧整体后移，再把左侧尾部搬过去
+            int moved = leftKeyCount - leftCount;
+            moveRange(rightPage->keys, rightPage->keys + rightKeyCount, rightPage->keys + moved);
+            moveRange(rightPage->values, rightPage->values + rightKeyCount, rightPage->values + moved);
+            moveRange(leftPage->keys + leftCount, leftPage->keys + leftKeyCount, rightPage->keys);
+            moveRange(leftPage->values + leftCount, leftPage->values + leftKeyCount, rightPage->values);
+        } else {
+            // 右 -> 左：把右侧头部搬到左侧尾部，右侧整体前移
+            int moved = leftCount - leftKeyCount;
+            moveRange(rightPage->keys, rightPage->keys + moved, leftPage->keys + leftKeyCount);
+            moveRange(rightPage->values, rightPage->values + moved, leftPage->values + leftKeyCount);
+            moveRange(rightPage->keys + moved, rightPage->keys + rightKeyCount, rightPage->keys);
+            moveRange(rightPage->values + moved, rightPage->values + rightKeyCount, rightPage->values);
+        }
+        leftPage->header.keyCount = leftCount;
+        rightPage->header.keyCount = total - leftCount;
+        parentPage->keys[sepIdx] = separatorOf(leftPage, rightPage);
+        parentPage->counts[sepIdx] = leftCount;
+        parentPage->counts[sepIdx + 1] = total - leftCount;
+        refreshLeafPage(leftPageId);
+        refreshLeafPage(rightPageId);
+        bufferPool.flushPage(parentPageId);
+    }
+
+    // 叶子下溢处理：根叶子允许为空，其余与兄弟合并或重分配
+    void handleLeafUnderflow(PageID leafPageId, DescentPath& path) {
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        if (path.depth == 0 || (int)leafPage->header.keyCount >= minLeafKeys()) {
+            bufferPool.flushPage(leafPageId);
+            return;
+        }
+
+        InternalPageType* parentPage = bufferPool.fetchInternalPage(path.pageIds[path.depth - 1]);
+        int idx = path.childIndexes[path.depth - 1];
+        if (idx > 0) {
+            rebalanceLeaves(path, parentPage->children[idx - 1], leafPageId, idx - 1);
+        } else {
+            rebalanceLeaves(path, leafPageId, parentPage->children[1], 0);
+        }
+    }
+
+public:
+    // ord 为 0 时使用页大小允许的最大扇出；否则按 B+ 树阶数限制每页键数（不超过页容量）
+    PagedBPlusTree(int ord = 0, const Compare& compare = Compare()) : comp(compare) {
+        maxLeafKeys = LeafPageType::CAPACITY;
+        maxInternalKeys = InternalPageType::CAPACITY;
+        if (ord > 0) {
+            maxLeafKeys = std::min(maxLeafKeys, std::max(ord - 1, 2));
+            maxInternalKeys = std::min(maxInternalKeys, std::max(ord - 1, 2));
+        }
+
+        rootPageId = bufferPool.allocatePage();
+        bufferPool.newLeafPage(rootPageId);
+        firstLeafPageId = rootPageId;
+        structureVersion = 0;
+        lastLeafPageId = INVALID_PAGE_ID;
+        lastLeafVersion = 0;
+        leafHintEnabled = false;
+        leafHintHits = 0;
+        leafHintMisses = 0;
+        leafFiltersEnabled = false;
+        filterNegatives = 0;
+        
+        std::cout << "[INIT] 创建根页面 " << rootPageId << "\n";
+    }
+
+    ~PagedBPlusTree() {
+        flush();
+    }
+
+    class ValueReader;
+
+    // ============ 游标 ============
+    // 钉住当前叶子页，按键序双向流式访问；key() 直接返回页内引用，value() 返回不复制、不分配的视图
+    // （原样存放的值为页内引用，std::string 值为 StringValueView，溢出部分经 openValueReader() 流式读取）
+    // 与迭代器相同，树被修改后已打开的游标失效，需要重新 seek
+    class Cursor {
+    private:
+        PagedBPlusTree* tree;
+        PageID leafPageId;
+        LeafPageType* leafPage;
+        int slot;
+
+        // 切换到另一个叶子（INVALID_PAGE_ID 表示越界）
+        void moveToLeaf(PageID pageId) {
+            if (leafPageId != INVALID_PAGE_ID) {
+                tree->bufferPool.unpinPage(leafPageId);
+            }
+            leafPageId = pageId;
+            leafPage = pageId != INVALID_PAGE_ID ? static_cast<LeafPageType*>(tree->bufferPool.pinPage(pageId)) : NULL;
+        }
+
+    public:
+        explicit Cursor(PagedBPlusTree* t)
+            : tree(t), leafPageId(INVALID_PAGE_ID), leafPage(NULL), slot(0) {}
+
+        Cursor(Cursor&& other)
+            : tree(other.tree), leafPageId(other.leafPageId), leafPage(other.leafPage), slot(other.slot) {
+            other.leafPageId = INVALID_PAGE_ID;
+            other.leafPage = NULL;
+        }
+
+        Cursor(const Cursor&) = delete;
+        Cursor& operator=(const Cursor&) = delete;
+
+        ~Cursor() {
+            moveToLeaf(INVALID_PAGE_ID);
+        }
+
+        bool isValid() const {
+            return leafPage != NULL && slot < (int)leafPage->header.keyCount;
+        }
+
+        // 定位到第一个 >= key 的条目
+        void seek(const KeyType& key) {
+            moveToLeaf(tree->locateLeafPage(key));
+            slot = tree->leafLowerBound(leafPage, key);
+            if (slot == (int)leafPage->header.keyCount) {
+                moveToLeaf(leafPage->header.nextPageId);
+                slot = 0;
+            }
+        }
+
+        // 定位到最小的条目
+        void seekToFirst() {
+            moveToLeaf(tree->firstLeafPageId);
+            slot = 0;
+        }
+
+        // 定位到最大的条目
+        void seekToLast() {
+            moveToLeaf(tree->findLastLeafPage());
+            slot = (int)leafPage->header.keyCount - 1;
+            if (slot < 0) moveToLeaf(INVALID_PAGE_ID);
+        }
+
+        // 定位到最后一个 <= key 的条目（反向扫描的起点）
+        void seekForPrev(const KeyType& key) {
+            moveToLeaf(tree->locateLeafPage(key));
+            slot = tree->leafLowerBound(leafPage, key);
+            if (slot < (int)leafPage->header.keyCount && !tree->keyLess(key, leafPage->keys[slot])) slot++;
+            if (slot == 0) {
+                // 本叶子的键都大于 key，目标在前一个叶子的末尾
+                moveToLeaf(leafPage->header.prevPageId);
+                slot = leafPage != NULL ? (int)leafPage->header.keyCount : 0;
+            }
+            slot--;
+            if (slot < 0) moveToLeaf(INVALID_PAGE_ID);
+        }
+
+        // 前进一条，越过叶子末尾时沿 nextPageId 切换叶子
+        bool next() {
+            if (!isValid()) return false;
+            if (++slot == (int)leafPage->header.keyCount) {
+                moveToLeaf(leafPage->header.nextPageId);
+                slot = 0;
+            }
+            return isValid();
+        }
+
+        // 后退一条，越过叶子开头时沿 prevPageId 切换叶子
+        bool prev() {
+            if (!isValid()) return false;
+            if (slot == 0) {
+                moveToLeaf(leafPage->header.prevPageId);
+                slot = leafPage != NULL ? (int)leafPage->header.keyCount - 1 : 0;
+            } else {
+                slot--;
+            }
+            return isValid();
+        }
+
+        const KeyType& key() const { return leafPage->keys[slot]; }
+        ValueView value() const { return Storage::view(tree->valueLog, leafPage->values[slot]); }
+
+        // 解码出完整的值（std::string 值会拼接溢出页并分配内存），供返回结果集合的接口使用
+        ValueRef decodeValue() const { return Storage::decode(tree->bufferPool, tree->valueLog, leafPage->values[slot]); }
+
+        // 流式读取当前值（仅 std::string 值）
+        ValueReader openValueReader() const { return ValueReader(tree, leafPage->values[slot]); }
+    };
+
+    Cursor openCursor() {
+        return Cursor(this);
+    }
+
+    // ============ 值的流式读取（仅 std::string 值） ============
+    // 先读槽内的内联前缀，再逐页读取溢出链，不把整个值装入内存；读取期间钉住当前溢出页
+    // 值位于值日志中时直接按偏移读取日志
+    // 读取器持有槽的副本，与游标相同，树被修改（包括写操作触发的日志回收）后读取器失效
+    class ValueReader {
+    private:
+        PagedBPlusTree* tree;
+        bool found;
+        StringSlot slot;
+        uint32_t position;      // 已读取的字节数
+        PageID pageId;          // 当前钉住的溢出页
+        OverflowPage* page;
+        uint32_t pageOffset;    // 在当前溢出页中的偏移
+
+        void moveToPage(PageID nextPageId) {
+            if (pageId != INVALID_PAGE_ID) {
+                tree->bufferPool.unpinPage(pageId);
+            }
+            pageId = nextPageId;
+            page = pageId != INVALID_PAGE_ID ? static_cast<OverflowPage*>(tree->bufferPool.pinPage(pageId)) : NULL;
+            pageOffset = 0;
+        }
+
+    public:
+        explicit ValueReader(PagedBPlusTree* t)
+            : tree(t), found(false), slot(), position(0), pageId(INVALID_PAGE_ID), page(NULL), pageOffset(0) {}
+
+        ValueReader(PagedBPlusTree* t, const StringSlot& s)
+            : tree(t), found(true), slot(s), position(0), pageId(INVALID_PAGE_ID), page(NULL), pageOffset(0) {}
+
+        ValueReader(ValueReader&& other)
+            : tree(other.tree), found(other.found), slot(other.slot), position(other.position),
+              pageId(other.pageId), page(other.page), pageOffset(other.pageOffset) {
+            other.pageId = INVALID_PAGE_ID;
+            other.page = NULL;
+        }
+
+        ValueReader(const ValueReader&) = delete;
+        ValueReader& operator=(const ValueReader&) = delete;
+
+        ~ValueReader() {
+            moveToPage(INVALID_PAGE_ID);
+        }
+
+        bool isValid() const { return found; }
+        uint32_t size() const { return slot.length; }
+        uint32_t remaining() const { return slot.length - position; }
+
+        // 最多读取 n 个字节到 out，返回实际读取的字节数（读完后返回 0）
+        size_t read(char* out, size_t n) {
+            size_t done = 0;
+            if (slot.logOffset != VALUE_LOG_NONE) {
+                size_t chunk = std::min<size_t>(n, slot.length - position);
+                std::memcpy(out, tree->valueLog.valueData(slot.logOffset) + position, chunk);
+                position += chunk;
+                return chunk;
+            }
+            while (done < n && position < slot.length) {
+                if (position < (uint32_t)VALUE_INLINE_BYTES) {
+                    size_t chunk = std::min<size_t>(n - done, std::min<uint32_t>(slot.length, VALUE_INLINE_BYTES) - position);
+                    std::memcpy(out + done, slot.inlineData + position, chunk);
+                    done += chunk;
+                    position += chunk;
+                    continue;
+                }
+                if (page == NULL) {
+                    moveToPage(slot.overflowPageId);
+                } else if (pageOffset == page->header.keyCount) {
+                    moveToPage(page->header.nextPageId);
+                }
+                size_t chunk = std::min<size_t>(n - done, page->header.keyCount - pageOffset);
+                std::memcpy(out + done, page->data + pageOffset, chunk);
+                done += chunk;
+                position += chunk;
+                pageOffset += chunk;
+            }
+            return done;
+        }
+    };
+
+    ValueReader openValueReader(const KeyType& key) {
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(locateLeafPage(key));
+        int pos = leafLowerBound(leafPage, key);
+        if (pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos])) {
+            return ValueReader(this, leafPage->values[pos]);
+        }
+        return ValueReader(this);
+    }
+
+    // 写出推迟落盘的页面（写操作只把子树计数变化的祖先页标为脏页）
+    void flush() {
+        bufferPool.flushDirtyPages();
+    }
+
+    // 页容量（按叶子页中实际保存的值类型推导，std::string 值对应 StringSlot 槽）
+    static uint32_t leafCapacity() { return LeafPageType::CAPACITY; }
+    static uint32_t internalCapacity() { return InternalPageType::CAPACITY; }
+
+    // 供建立在树之上的结构（如非唯一索引的溢出页）共用同一个缓冲池
+    BufferPoolManager<KeyType, StoredValue>& getBufferPool() {
+        return bufferPool;
+    }
+    
+    // 插入
+    void insert(KeyType key, const ValueType& newValue) {
+        std::cout << "\n[INSERT] 插入 key=" << key << "\n";
+        maybeCollectValueLog();
+        StoredValue value = Storage::encode(bufferPool, valueLog, key, newValue);
+        
+        // 追加快速路径：键大于最后一个叶子的最大键
+        if (lastLeafPageId != INVALID_PAGE_ID && lastLeafVersion == structureVersion) {
+            LeafPageType* lastLeaf = bufferPool.fetchLeafPage(lastLeafPageId);
+            int count = lastLeaf->header.keyCount;
+            if (count > 0 && keyLess(lastLeaf->keys[count - 1], key)) {
+                adjustPathCounts(lastLeafPath, 1);
+                if (count < maxLeafKeys) {
+                    lastLeaf->keys[count] = key;
+                    lastLeaf->values[count] = value;
+                    lastLeaf->header.keyCount++;
+                    addToLeafFilter(lastLeafPageId, key);
+                    updateSearchMode(lastLeafPageId);
+                    bufferPool.flushPage(lastLeafPageId);
+                } else {
+                    DescentPath path = lastLeafPath;
+                    splitLeafPage(lastLeafPageId, key, value, path);
+                }
+                return;
+            }
+        }
+        
+        DescentPath path;
+        PageID leafPageId = locateLeafPage(key, &path);
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        if (leafPage->header.nextPageId == INVALID_PAGE_ID) {
+            lastLeafPageId = leafPageId;
+            lastLeafPath = path;
+            lastLeafVersion = structureVersion;
+        }
+        
+        // 检查是否已存在
+        int pos = leafLowerBound(leafPage, key);
+        if (pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos])) {
+            Storage::release(bufferPool, valueLog, leafPage->values[pos]);
+            leafPage->values[pos] = value;
+            bufferPool.flushPage(leafPageId);
+            return;
+        }
+        
+        adjustPathCounts(path, 1);
+        if ((int)leafPage->header.keyCount < maxLeafKeys) {
+            // 移动键值
+            int count = leafPage->header.keyCount;
+            moveRange(leafPage->keys + pos, leafPage->keys + count, leafPage->keys + pos + 1);
+            moveRange(leafPage->values + pos, leafPage->values + count, leafPage->values + pos + 1);
+            
+            leafPage->keys[pos] = key;
+            leafPage->values[pos] = value;
+            leafPage->header.keyCount++;
+            addToLeafFilter(leafPageId, key);
+            updateSearchMode(leafPageId);
+            
+            bufferPool.flushPage(leafPageId);
+        } else {
+            splitLeafPage(leafPageId, key, value, path);
+        }
+    }
+
+    // 批量插入：排序后每个目标叶子只下降一次，归并写入并至多分裂一次
+    // 就地排序、去重并消耗 entries（调用方 std::move 传入），条目只移动不复制
+    void insertBatch(std::vector<std::pair<KeyType, ValueType> >&& entries) {
+        std::cout << "\n[BATCH] 批量插入 " << entries.size() << " 条\n";
+        if (entries.empty()) return;
+        maybeCollectValueLog();
+
+        // 稳定排序后去重，同一个键保留最后一次写入（与逐条 insert 的覆盖语义一致）
+        std::stable_sort(entries.begin(), entries.end(), KeyLess(comp));
+        size_t unique = 0;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (unique > 0 && !keyLess(entries[unique - 1].first, entries[i].first)) {
+                entries[unique - 1].second = std::move(entries[i].second);
+            } else {
+                if (unique != i) entries[unique] = std::move(entries[i]);
+                unique++;
+            }
+        }
+        entries.resize(unique);
+
+        size_t begin = 0;
+        while (begin < entries.size()) {
+            DescentPath path;
+            PageID leafPageId = findLeafPage(entries[begin].first, &path);
+            KeyType upperBound = KeyType();
+            bool hasUpperBound = upperBoundOf(path, upperBound);
+
+            // 收集落在同一叶子中的所有键
+            size_t end = begin + 1;
+            while (end < entries.size() && (!hasUpperBound || keyLess(entries[end].first, upperBound))) {
+                end++;
+            }
+
+            mergeIntoLeaf(leafPageId, path, entries, begin, end);
+            begin = end;
+        }
+    }
+
+    // 删除
+    bool remove(KeyType key) {
+        std::cout << "\n[DELETE] 删除 key=" << key << "\n";
+        maybeCollectValueLog();
+
+        DescentPath path;
+        PageID leafPageId = locateLeafPage(key, &path);
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+
+        int pos = leafLowerBound(leafPage, key);
+        if (pos == (int)leafPage->header.keyCount || keyLess(key, leafPage->keys[pos])) {
+            return false;
+        }
+
+        Storage::release(bufferPool, valueLog, leafPage->values[pos]);
+
+        // 移动键值
+        int count = leafPage->header.keyCount;
+        moveRange(leafPage->keys + pos + 1, leafPage->keys + count, leafPage->keys + pos);
+        moveRange(leafPage->values + pos + 1, leafPage->values + count, leafPage->values + pos);
+        leafPage->header.keyCount--;
+        adjustPathCounts(path, -1);
+        updateSearchMode(leafPageId);
+
+        handleLeafUnderflow(leafPageId, path);
+        return true;
+    }
+
+    // 范围删除 [startKey, endKey]，每个叶子一次性删除落在范围内的键后再做一次下溢处理
+    size_t removeRange(KeyType startKey, KeyType endKey) {
+        std::cout << "\n[DELETE] 范围删除 [" << startKey << ", " << endKey << "]\n";
+        maybeCollectValueLog();
+
+        size_t removed = 0;
+        while (true) {
+            // 合并/重分配会改变结构，每轮重新下降
+            DescentPath path;
+            PageID leafPageId = findLeafPage(startKey, &path);
+            LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+
+            int begin = leafLowerBound(leafPage, startKey);
+
+            // 该叶子剩余键都小于 startKey 时，范围从下一个叶子开始（按其首键重新下降以取得路径）
+            if (begin == (int)leafPage->header.keyCount) {
+                if (leafPage->header.nextPageId == INVALID_PAGE_ID) break;
+                KeyType nextKey = bufferPool.fetchLeafPage(leafPage->header.nextPageId)->keys[0];
+                leafPageId = findLeafPage(nextKey, &path);
+                leafPage = bufferPool.fetchLeafPage(leafPageId);
+                begin = 0;
+            }
+
+            int end = begin;
+            while (end < (int)leafPage->header.keyCount && !keyLess(endKey, leafPage->keys[end])) end++;
+            if (end == begin) break;
+
+            int count = end - begin;
+            for (int i = begin; i < end; i++) {
+                Storage::release(bufferPool, valueLog, leafPage->values[i]);
+            }
+            int keyCount = leafPage->header.keyCount;
+            moveRange(leafPage->keys + end, leafPage->keys + keyCount, leafPage->keys + begin);
+            moveRange(leafPage->values + end, leafPage->values + keyCount, leafPage->values + begin);
+            leafPage->header.keyCount -= count;
+            removed += count;
+            adjustPathCounts(path, -count);
+            updateSearchMode(leafPageId);
+
+            handleLeafUnderflow(leafPageId, path);
+        }
+
+        return removed;
+    }
+
+    // 查找
+    bool search(KeyType key, ValueType& value) {
+        PageID leafPageId = locateLeafPage(key);
+
+        // 过滤器判定不存在时直接返回，不读取叶子页
+        if (leafFiltersEnabled && !leafFilters[leafPageId].mayContain(filterHash(key))) {
+            filterNegatives++;
+            std::cout << "[SEARCH] 过滤器排除 key=" << key << "\n";
+            return false;
+        }
+
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        
+        std::cout << "[SEARCH] 在页面 " << leafPageId << " 中查找 key=" << key << "\n";
+        
+        int pos = leafLowerBound(leafPage, key);
+        if (pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos])) {
+            value = Storage::decode(bufferPool, valueLog, leafPage->values[pos]);
+            return true;
+        }
+        return false;
+    }
+    
+    // ============ 顺序统计 ============
+    // 条目总数
+    SubtreeCount size() {
+        return subtreeSize(rootPageId);
+    }
+
+    // 排名：小于 key 的条目数（即 key 在键序中的下标）
+    SubtreeCount rank(KeyType key) {
+        return countBefore(key, false);
+    }
+
+    // 范围计数：[startKey, endKey] 内的条目数，不物化结果
+    SubtreeCount countRange(KeyType startKey, KeyType endKey) {
+        if (keyLess(endKey, startKey)) return 0;
+        return countBefore(endKey, true) - countBefore(startKey, false);
+    }
+
+    // 选择：按键序取第 index 个条目（从 0 开始），越界返回 false
+    bool select(SubtreeCount index, KeyType& key, ValueType& value) {
+        Page* page = bufferPool.fetchPage(rootPageId);
+        while (page->header.pageType != LEAF_PAGE) {
+            InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+            int pos = 0;
+            while (pos < (int)internalPage->header.keyCount && index >= internalPage->counts[pos]) {
+                index -= internalPage->counts[pos];
+                pos++;
+            }
+            page = bufferPool.fetchPage(internalPage->children[pos]);
+        }
+        LeafPageType* leafPage = static_cast<LeafPageType*>(page);
+        if (index >= leafPage->header.keyCount) return false;
+        key = leafPage->keys[index];
+        value = Storage::decode(bufferPool, valueLog, leafPage->values[index]);
+        return true;
+    }
+
+    // 批量查找：每组 MULTI_GET_GROUP 个键逐层同步下降
+    // 每个查找确定下一层页面后先发出预取，再处理组内其它查找，
+    // 使各条下降路径上的缓存缺失相互重叠：先为整组预取页头，页头到达后再按键数预取查找键。
+    // 只有页面内容的缺失被重叠，fetchPage 的页表哈希查找仍逐个同步完成。
+    // 结果按输入顺序写入 values/found，返回找到的个数
+    size_t multiGet(const std::vector<KeyType>& keys, std::vector<ValueType>& values, std::vector<bool>& found) {
+        std::cout << "[MULTIGET] 批量查找 " << keys.size() << " 个键\n";
+
+        values.assign(keys.size(), ValueType());
+        found.assign(keys.size(), false);
+        size_t foundCount = 0;
+
+        Page* pages[MULTI_GET_GROUP];
+        for (size_t groupBegin = 0; groupBegin < keys.size(); groupBegin += MULTI_GET_GROUP) {
+            int groupSize = (int)std::min<size_t>(MULTI_GET_GROUP, keys.size() - groupBegin);
+            Page* root = bufferPool.fetchPage(rootPageId);
+            for (int i = 0; i < groupSize; i++) pages[i] = root;
+
+            // 所有查找同层推进（树是平衡的，组内同时到达叶子）
+            while (pages[0]->header.pageType != LEAF_PAGE) {
+                for (int i = 0; i < groupSize; i++) {
+                    const KeyType& key = keys[groupBegin + i];
+                    InternalPageType* internalPage = static_cast<InternalPageType*>(pages[i]);
+                    pages[i] = bufferPool.fetchPage(internalPage->children[childIndexOf(internalPage, key)]);
+                    prefetchPage(pages[i]);
+                }
+                for (int i = 0; i < groupSize; i++) prefetchSearchKeys(pages[i]);
+            }
+
+            for (int i = 0; i < groupSize; i++) {
+                const KeyType& key = keys[groupBegin + i];
+                LeafPageType* leafPage = static_cast<LeafPageType*>(pages[i]);
+                int pos = leafLowerBound(leafPage, key);
+                if (pos < (int)leafPage->header.keyCount && !keyLess(key, leafPage->keys[pos])) {
+                    values[groupBegin + i] = Storage::decode(bufferPool, valueLog, leafPage->values[pos]);
+                    found[groupBegin + i] = true;
+                    foundCount++;
+                }
+            }
+        }
+        return foundCount;
+    }
+
+    // 范围查询
+    std::vector<std::pair<KeyType, ValueType> > rangeQuery(KeyType startKey, KeyType endKey) {
+        std::vector<std::pair<KeyType, ValueType> > result;
+        
+        std::cout << "[RANGE] 范围查询 [" << startKey << ", " << endKey << "]\n";
         
+        Cursor cursor = openCursor();
+        for (cursor.seek(startKey); cursor.isValid() && !keyLess(endKey, cursor.key()); cursor.next()) {
+            result.push_back(std::make_pair(cursor.key(), cursor.decodeValue()));
+        }
+        
+        return result;
+    }
+
+    // 范围聚合：把 [startKey, endKey] 内每个叶子的连续值段直接交给 aggregator
+    // 不复制值、不分配内存；aggregator 需提供 accumulate(const ValueType*, size_t)
+    template<typename Aggregator>
+    void scanAggregate(KeyType startKey, KeyType endKey, Aggregator& aggregator) {
+        std::cout << "[AGGREGATE] 范围聚合 [" << startKey << ", " << endKey << "]\n";
+        if (keyLess(endKey, startKey)) return;
+
+        PageID leafPageId = locateLeafPage(startKey);
+        LeafPageType* leafPage = bufferPool.fetchLeafPage(leafPageId);
+        int begin = leafLowerBound(leafPage, startKey);
+
+        while (leafPage != NULL) {
+            int count = leafPage->header.keyCount;
+            int end = count;
+            bool last = count > 0 && keyLess(endKey, leafPage->keys[count - 1]);
+            if (last) {
+                end = begin;
+                while (end < count && !keyLess(endKey, leafPage->keys[end])) end++;
+            }
+            aggregator.accumulate(leafPage->values + begin, end - begin);
+            if (last || leafPage->header.nextPageId == INVALID_PAGE_ID) break;
+
+            leafPage = bufferPool.fetchLeafPage(leafPage->header.nextPageId);
+            begin = 0;
+        }
+    }
+
+    // 反向范围查询：按键降序返回 [startKey, endKey]，从 endKey 处沿 prevPageId 向前扫描
+    std::vector<std::pair<KeyType, ValueType> > reverseRangeQuery(KeyType startKey, KeyType endKey) {
+        std::vector<std::pair<KeyType, ValueType> > result;
+
+        std::cout << "[RANGE] 反向范围查询 [" << endKey << ", " << startKey << "]\n";
+
+        Cursor cursor = openCursor();
+        for (cursor.seekForPrev(endKey); cursor.isValid() && !keyLess(cursor.key(), startKey); cursor.prev()) {
+            result.push_back(std::make_pair(cursor.key(), cursor.decodeValue()));
+        }
+
+        return result;
+    }
+
+    // 最近 N 条：按键降序返回不超过 key 的最多 n 个条目，只访问实际需要的叶子
+    std::vector<std::pair<KeyType, ValueType> > lastN(KeyType key, size_t n) {
+        std::vector<std::pair<KeyType, ValueType> > result;
+
+        std::cout << "[RANGE] 查询 key<=" << key << " 的最后 " << n << " 条\n";
+
+        Cursor cursor = openCursor();
+        for (cursor.seekForPrev(key); cursor.isValid() && result.size() < n; cursor.prev()) {
+            result.push_back(std::make_pair(cursor.key(), cursor.decodeValue()));
+        }
+
         return result;
     }
     
+    // 叶子提示开关（默认关闭），关闭时清空提示与命中统计
+    void setLeafHintEnabled(bool enabled) {
+        leafHintEnabled = enabled;
+        leafHint = LeafHint();
+        leafHintHits = 0;
+        leafHintMisses = 0;
+    }
+
+    // 叶子布隆过滤器开关（默认关闭）：开启时为现有叶子全部建立过滤器，关闭时释放
+    void setLeafFiltersEnabled(bool enabled) {
+        static_assert(HasStdHash<KeyType>::value, "叶子布隆过滤器需要 std::hash<KeyType>");
+        leafFilters.clear();
+        filterNegatives = 0;
+        leafFiltersEnabled = enabled;
+        if (!enabled) return;
+        for (PageID pageId = firstLeafPageId; pageId != INVALID_PAGE_ID;
+             pageId = bufferPool.fetchLeafPage(pageId)->header.nextPageId) {
+            rebuildLeafFilter(pageId);
+        }
+    }
+
+    // 被过滤器直接排除的查找次数
+    uint64_t getFilterNegatives() const { return filterNegatives; }
+
+    // 键值分离开关（默认关闭，仅 std::string 值且键可平凡复制）：开启后不小于 threshold 字节的新值写入值日志
+    // 关闭只影响之后的写入，已在日志中的值照常读取和回收
+    void setValueLogEnabled(bool enabled, uint32_t threshold = VALUE_LOG_DEFAULT_THRESHOLD) {
+        valueLog.setEnabled(enabled, threshold);
+    }
+
+    // 立即回收整个值日志（平时由写操作增量回收）
+    void compactValueLog() {
+        collectValueLog(valueLog.tail() - valueLog.head());
+    }
+
+    uint64_t getValueLogBytes() const { return valueLog.tail() - valueLog.head(); }
+    uint64_t getValueLogGarbage() const { return valueLog.garbage(); }
+
+    uint64_t getLeafHintHits() const { return leafHintHits; }
+    uint64_t getLeafHintMisses() const { return leafHintMisses; }
+
+    void printLeafHintStats() {
+        uint64_t total = leafHintHits + leafHintMisses;
+        std::cout << "\n[STATS] 叶子提示命中: " << leafHintHits << " / " << total;
+        if (total > 0) std::cout << " (" << (leafHintHits * 100 / total) << "%)";
+        std::cout << "\n";
+    }
+
     // 打印树结构
     void print() {
         std::cout << "\n=== B+树结构 ===\n";
@@ -447,20 +2668,26 @@ public:
             
             for (size_t idx = 0; idx < currentLevel.size(); idx++) {
                 PageID pageId = currentLevel[idx];
-                Page<KeyType, ValueType>* page = bufferPool.fetchPage(pageId);
+                Page* page = bufferPool.fetchPage(pageId);
                 std::cout << "[Page" << pageId << ":";
                 
-                for (int i = 0; i < (int)page->header.keyCount; i++) {
-                    std::cout << page->keys[i];
-                    if (i < (int)page->header.keyCount - 1) std::cout << ",";
-                }
-                std::cout << "] ";
-                
                 if (page->header.pageType == INTERNAL_PAGE) {
+                    InternalPageType* internalPage = static_cast<InternalPageType*>(page);
+                    for (int i = 0; i < (int)page->header.keyCount; i++) {
+                        std::cout << internalPage->keys[i];
+                        if (i < (int)page->header.keyCount - 1) std::cout << ",";
+                    }
                     for (int i = 0; i <= (int)page->header.keyCount; i++) {
-                        nextLevel.push_back(page->children[i]);
+                        nextLevel.push_back(internalPage->children[i]);
+                    }
+                } else {
+                    LeafPageType* leafPage = static_cast<LeafPageType*>(page);
+                    for (int i = 0; i < (int)page->header.keyCount; i++) {
+                        std::cout << leafPage->keys[i];
+                        if (i < (int)page->header.keyCount - 1) std::cout << ",";
                     }
                 }
+                std::cout << "] ";
             }
             std::cout << "\n";
             currentLevel = nextLevel;
@@ -470,11 +2697,252 @@ public:
     }
 };
 
+// ============ 非唯一索引 ============
+// 重复键模式：每个键映射到一个 PostingList，插入同一键的多个行号时不再覆盖
+// 递增的行号直接追加到编码尾部；乱序插入和删除需要解码后重新编码该键的列表
+template<typename KeyType, typename Compare = std::less<KeyType> >
+class NonUniqueIndex {
+private:
+    typedef PagedBPlusTree<KeyType, PostingList, Compare> TreeType;
+
+    TreeType tree;
+
+    // 把字节追加到溢出链尾部，尾页写满时接上新页
+    // 写满的页在接上后继时落盘，最后的尾页在返回前落盘，每页只写一次
+    void appendToChain(PostingList& list, const uint8_t* bytes, uint32_t n) {
+        BufferPoolManager<KeyType, PostingList>& pool = tree.getBufferPool();
+        OverflowPage* tail = list.tailPageId != INVALID_PAGE_ID ? pool.fetchOverflowPage(list.tailPageId) : NULL;
+        while (n > 0) {
+            if (tail == NULL || tail->header.keyCount == OverflowPage::CAPACITY) {
+                PageID newPageId = pool.allocatePage();
+                pool.newOverflowPage(newPageId);
+                if (tail == NULL) {
+                    list.overflowPageId = newPageId;
+                } else {
+                    tail->header.nextPageId = newPageId;
+                    pool.flushPage(list.tailPageId);
+                }
+                list.tailPageId = newPageId;
+                tail = pool.fetchOverflowPage(newPageId);
+            }
+            uint32_t chunk = std::min(n, OverflowPage::CAPACITY - tail->header.keyCount);
+            std::memcpy(tail->data + tail->header.keyCount, bytes, chunk);
+            tail->header.keyCount += chunk;
+            bytes += chunk;
+            n -= chunk;
+        }
+        if (tail != NULL) {
+            pool.flushPage(list.tailPageId);
+        }
+    }
+
+    // 编码后的字节放入列表：放得下时内联，否则整体追加到溢出链
+    void storeBytes(PostingList& list, const uint8_t* bytes, uint32_t n) {
+        if (list.overflowPageId == INVALID_PAGE_ID && list.byteCount + n <= (uint32_t)POSTING_INLINE_BYTES) {
+            std::memcpy(list.inlineData + list.byteCount, bytes, n);
+        } else if (list.overflowPageId == INVALID_PAGE_ID) {
+            // 内联空间不足：已有字节与新字节一起迁入溢出链
+            std::vector<uint8_t> buffer(list.inlineData, list.inlineData + list.byteCount);
+            buffer.insert(buffer.end(), bytes, bytes + n);
+            appendToChain(list, buffer.data(), buffer.size());
+        } else {
+            appendToChain(list, bytes, n);
+        }
+        list.byteCount += n;
+    }
+
+    // 在列表尾部追加一个大于 lastValue 的行号
+    void appendValue(PostingList& list, uint64_t value) {
+        uint8_t buffer[MAX_VARINT_BYTES];
+        int n = encodeVarint(list.count == 0 ? value : value - list.lastValue, buffer);
+        storeBytes(list, buffer, n);
+        list.count++;
+        list.lastValue = value;
+    }
+
+    void freeChain(PostingList& list) {
+        BufferPoolManager<KeyType, PostingList>& pool = tree.getBufferPool();
+        PageID pageId = list.overflowPageId;
+        while (pageId != INVALID_PAGE_ID) {
+            PageID nextPageId = pool.fetchOverflowPage(pageId)->header.nextPageId;
+            pool.deallocatePage(pageId);
+            pageId = nextPageId;
+        }
+        list.overflowPageId = INVALID_PAGE_ID;
+        list.tailPageId = INVALID_PAGE_ID;
+    }
+
+    // 按升序行号重新编码整个列表
+    void rebuild(PostingList& list, const std::vector<uint64_t>& values) {
+        freeChain(list);
+        list = PostingList();
+        if (values.empty()) return;
+
+        // 先整体编码到缓冲区，再一次性写入，溢出链每页只落盘一次
+        std::vector<uint8_t> buffer(values.size() * MAX_VARINT_BYTES);
+        uint32_t n = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            n += encodeVarint(i == 0 ? values[i] : values[i] - values[i - 1], buffer.data() + n);
+        }
+        storeBytes(list, buffer.data(), n);
+        list.count = values.size();
+        list.lastValue = values.back();
+    }
+
+    // 解码整个列表（乱序插入/删除时重新编码用）
+    std::vector<uint64_t> collect(const PostingList& list) {
+        std::vector<uint64_t> values;
+        values.reserve(list.count);
+        for (Iterator it(&tree.getBufferPool(), list); it.isValid(); it.next()) {
+            values.push_back(it.value());
+        }
+        return values;
+    }
+
+public:
+    // ============ 行号迭代器 ============
+    // 按需逐字节解码，不展开整个列表；与 ValueReader 相同钉住当前溢出页，
+    // 持有期间释放该页会告警。索引被修改后需要重新 find
+    class Iterator {
+    private:
+        BufferPoolManager<KeyType, PostingList>* pool;
+        PostingList list;
+        PageID pageId;             // 当前钉住的溢出页，INVALID_PAGE_ID 表示读内联数据
+        const OverflowPage* page;
+        uint32_t offset;
+        uint32_t remaining;
+        uint64_t current;
+        bool valid;
+
+        void moveToPage(PageID nextPageId) {
+            if (pageId != INVALID_PAGE_ID) {
+                pool->unpinPage(pageId);
+            }
+            pageId = nextPageId;
+            page = pageId != INVALID_PAGE_ID ? static_cast<const OverflowPage*>(pool->pinPage(pageId)) : NULL;
+            offset = 0;
+        }
+
+        uint8_t readByte() {
+            if (page == NULL) return list.inlineData[offset++];
+            if (offset == page->header.keyCount) {
+                moveToPage(page->header.nextPageId);
+            }
+            return page->data[offset++];
+        }
+
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; ; shift += 7) {
+                uint8_t byte = readByte();
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+        }
+
+    public:
+        Iterator(BufferPoolManager<KeyType, PostingList>* p, const PostingList& l)
+            : pool(p), list(l), pageId(INVALID_PAGE_ID), page(NULL), offset(0), remaining(l.count), current(0), valid(false) {
+            moveToPage(list.overflowPageId);
+            next();
+        }
+
+        Iterator(Iterator&& other)
+            : pool(other.pool), list(other.list), pageId(other.pageId), page(other.page), offset(other.offset),
+              remaining(other.remaining), current(other.current), valid(other.valid) {
+            other.pageId = INVALID_PAGE_ID;
+            other.page = NULL;
+            other.remaining = 0;
+            other.valid = false;
+        }
+
+        Iterator(const Iterator&) = delete;
+        Iterator& operator=(const Iterator&) = delete;
+
+        ~Iterator() {
+            moveToPage(INVALID_PAGE_ID);
+        }
+
+        bool isValid() const { return valid; }
+        uint64_t value() const { return current; }
+
+        bool next() {
+            if (remaining == 0) {
+                valid = false;
+                return false;
+            }
+            uint64_t delta = readVarint();
+            current = remaining == list.count ? delta : current + delta;
+            remaining--;
+            valid = true;
+            return true;
+        }
+    };
+
+    explicit NonUniqueIndex(int ord = 0, const Compare& compare = Compare()) : tree(ord, compare) {}
+
+    // 为 key 增加一个行号（已存在时忽略）
+    void insert(const KeyType& key, uint64_t rowId) {
+        PostingList list;
+        tree.search(key, list);
+
+        if (list.count > 0 && rowId <= list.lastValue) {
+            std::vector<uint64_t> values = collect(list);
+            std::vector<uint64_t>::iterator it = std::lower_bound(values.begin(), values.end(), rowId);
+            if (it != values.end() && *it == rowId) return;
+            values.insert(it, rowId);
+            rebuild(list, values);
+        } else {
+            appendValue(list, rowId);
+        }
+        tree.insert(key, list);
+    }
+
+    // 删除 key 的一个行号，列表为空时连同键一起删除
+    bool remove(const KeyType& key, uint64_t rowId) {
+        PostingList list;
+        if (!tree.search(key, list)) return false;
+
+        std::vector<uint64_t> values = collect(list);
+        std::vector<uint64_t>::iterator it = std::lower_bound(values.begin(), values.end(), rowId);
+        if (it == values.end() || *it != rowId) return false;
+        values.erase(it);
+
+        if (values.empty()) {
+            freeChain(list);
+            tree.remove(key);
+        } else {
+            rebuild(list, values);
+            tree.insert(key, list);
+        }
+        return true;
+    }
+
+    // key 对应的行号个数
+    size_t count(const KeyType& key) {
+        PostingList list;
+        return tree.search(key, list) ? list.count : 0;
+    }
+
+    // 按升序遍历 key 的行号（键不存在时迭代器直接无效）
+    Iterator find(const KeyType& key) {
+        PostingList list;
+        tree.search(key, list);
+        return Iterator(&tree.getBufferPool(), list);
+    }
+
+    void print() {
+        tree.print();
+    }
+};
+
 // ============ 测试代码 ============
 int main() {
     std::cout << "========== 页式B+树测试 ==========\n";
     std::cout << "页大小配置: " << PAGE_SIZE << " 字节\n";
-    std::cout << "每页最大键数: " << MAX_KEYS_PER_PAGE << "\n\n";
+    std::cout << "每页最大键数: 叶子 " << PagedBPlusTree<int, std::string>::leafCapacity()
+              << " / 内部 " << PagedBPlusTree<int, std::string>::internalCapacity()
+              << " (PagedBPlusTree<int, std::string>)\n\n";
     
     PagedBPlusTree<int, std::string> tree(4);
     
@@ -508,6 +2976,22 @@ int main() {
     for (size_t i = 0; i < results.size(); i++) {
         std::cout << "  " << results[i].first << " -> " << results[i].second << "\n";
     }
+
+    // 游标：从 key=20 开始正向读两条，再反向读回
+    PagedBPlusTree<int, std::string>::Cursor cursor = tree.openCursor();
+    cursor.seek(20);
+    for (int i = 0; i < 2 && cursor.isValid(); i++, cursor.next()) {
+        std::cout << "  游标 -> " << cursor.key() << " -> " << cursor.value() << "\n";
+    }
+    while (cursor.prev() && cursor.key() >= 15) {
+        std::cout << "  游标 <- " << cursor.key() << " -> " << cursor.value() << "\n";
+    }
+
+    // 反向查询：key<=32 的最后3条
+    std::vector<std::pair<int, std::string> > latest = tree.lastN(32, 3);
+    for (size_t i = 0; i < latest.size(); i++) {
+        std::cout << "  " << latest[i].first << " -> " << latest[i].second << "\n";
+    }
     
     // 测试4: 大量插入测试
     std::cout << "\n===== 测试4: 大量插入 =====\n";
@@ -517,6 +3001,158 @@ int main() {
     }
     std::cout << "插入20个元素后:\n";
     largeTree.print();
-    
+
+    // 测试5: 批量插入
+    std::cout << "\n===== 测试5: 批量插入 =====\n";
+    PagedBPlusTree<int, int> batchTree(5);
+    std::vector<std::pair<int, int> > batch;
+    for (int i = 60; i >= 1; i--) {
+        batch.push_back(std::make_pair(i * 3, i));
+    }
+    batchTree.insertBatch(std::move(batch));
+    batchTree.print();
+
+    // 测试6: 删除与合并
+    std::cout << "\n===== 测试6: 删除操作 =====\n";
+    for (int i = 1; i <= 40; i++) {
+        batchTree.remove(i * 3);
+    }
+    std::cout << "范围删除条数: " << batchTree.removeRange(120, 170) << "\n";
+    batchTree.print();
+
+    // 顺序统计：范围计数、排名与按下标选择
+    int selectedKey, selectedValue;
+    std::cout << "条目总数: " << batchTree.size()
+              << ", [100, 180] 内条目数: " << batchTree.countRange(100, 180)
+              << ", rank(150): " << batchTree.rank(150) << "\n";
+    if (batchTree.select(3, selectedKey, selectedValue)) {
+        std::cout << "第 3 个条目: " << selectedKey << " -> " << selectedValue << "\n";
+    }
+
+    // 测试7: 叶子提示（相邻键的查找跳过下降）与批量查找
+    std::cout << "\n===== 测试7: 叶子提示与批量查找 =====\n";
+    largeTree.setLeafHintEnabled(true);
+    int hintValue;
+    for (int i = 50; i <= 70; i++) {
+        largeTree.search(i, hintValue);
+    }
+    largeTree.printLeafHintStats();
+
+    // 叶子布隆过滤器：不存在的键不读取叶子页
+    largeTree.setLeafFiltersEnabled(true);
+    for (int i = 1001; i <= 1010; i++) {
+        largeTree.search(i * 7, hintValue);
+    }
+    std::cout << "过滤器排除次数: " << largeTree.getFilterNegatives() << " / 10\n";
+
+    // 批量查找
+    std::vector<int> lookupKeys;
+    for (int i = 0; i < 40; i++) {
+        lookupKeys.push_back(i * 7);
+    }
+    std::vector<int> lookupValues;
+    std::vector<bool> lookupFound;
+    size_t hitCount = largeTree.multiGet(lookupKeys, lookupValues, lookupFound);
+    std::cout << "批量查找命中: " << hitCount << " / " << lookupKeys.size() << "\n";
+
+    // 范围聚合：直接在叶子上折叠 [50, 150] 的值
+    ValueAggregate<int> aggregate;
+    largeTree.scanAggregate(50, 150, aggregate);
+    std::cout << "聚合 [50, 150]: count=" << aggregate.count << " sum=" << aggregate.sum
+              << " min=" << aggregate.min << " max=" << aggregate.max << "\n";
+
+    // 测试8: 非唯一索引
+    std::cout << "\n===== 测试8: 非唯一索引 =====\n";
+    NonUniqueIndex<int> secondary(4);
+    for (int row = 1; row <= 30; row++) {
+        secondary.insert(row % 3, row * 10);
+    }
+    secondary.insert(1, 5);
+    secondary.remove(2, 20);
+    size_t rowCount = secondary.count(1);
+    std::vector<uint64_t> rows;
+    for (NonUniqueIndex<int>::Iterator it = secondary.find(1); it.isValid(); it.next()) {
+        rows.push_back(it.value());
+    }
+    std::cout << "key=1 行数: " << rowCount << ", 行号:";
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::cout << " " << rows[i];
+    }
+    std::cout << "\n";
+
+    // 测试9: 多列可比较字节序键 (tenant_id, timestamp 降序, id)
+    std::cout << "\n===== 测试9: 可比较字节序复合键 =====\n";
+    typedef EncodedKey<16> TupleKey;
+    PagedBPlusTree<TupleKey, int, EncodedKeyCompare<16> > tupleTree(4);
+    int tenants[] = {2, -1, 2, 7, 2};
+    int64_t timestamps[] = {100, 300, 200, 50, 100};
+    for (int id = 0; id < 5; id++) {
+        KeyEncoder encoder;
+        encoder.appendInt32(tenants[id]).appendInt64(timestamps[id], true).appendUint32(id);
+        tupleTree.insert(TupleKey(encoder), id);
+    }
+    std::vector<std::string> tuples;
+    PagedBPlusTree<TupleKey, int, EncodedKeyCompare<16> >::Cursor tupleCursor = tupleTree.openCursor();
+    for (tupleCursor.seekToFirst(); tupleCursor.isValid(); tupleCursor.next()) {
+        KeyDecoder decoder = tupleCursor.key().decoder();
+        int32_t tenant = decoder.readInt32();
+        int64_t timestamp = decoder.readInt64(true);
+        uint32_t id = decoder.readUint32();
+        tuples.push_back("(" + std::to_string(tenant) + "," + std::to_string(timestamp) + "," + std::to_string(id) + ")");
+    }
+    std::cout << "按 (tenant, ts desc, id) 顺序:";
+    for (size_t i = 0; i < tuples.size(); i++) {
+        std::cout << " " << tuples[i];
+    }
+    std::cout << "\n";
+
+    // 测试10: 自定义比较器（降序树）
+    std::cout << "\n===== 测试10: 降序比较器 =====\n";
+    PagedBPlusTree<int, int, std::greater<int> > descTree(4);
+    for (int i = 1; i <= 12; i++) {
+        descTree.insert(i, i * i);
+    }
+    std::vector<std::pair<int, int> > descRange = descTree.rangeQuery(9, 4);
+    std::cout << "降序范围 [9, 4]:";
+    for (size_t i = 0; i < descRange.size(); i++) {
+        std::cout << " " << descRange[i].first;
+    }
+    std::cout << "\n";
+
+    // 测试11: 变长值（短值内联，长值写入溢出页链）
+    std::cout << "\n===== 测试11: 变长值溢出存储 =====\n";
+    PagedBPlusTree<int, std::string> blobTree(4);
+    blobTree.insert(1, "short");
+    blobTree.insert(2, std::string(10000, 'x'));
+    blobTree.insert(2, std::string(5000, 'y'));
+    std::string blob;
+    bool blobFound = blobTree.search(2, blob);
+    size_t streamed = 0;
+    size_t chunks = 0;
+    {
+        PagedBPlusTree<int, std::string>::ValueReader reader = blobTree.openValueReader(2);
+        char chunk[1024];
+        for (size_t n; (n = reader.read(chunk, sizeof(chunk))) > 0; chunks++) {
+            streamed += n;
+        }
+    }
+    blobTree.remove(2);
+    std::cout << "key=2 " << (blobFound ? "找到" : "未找到") << ", 长度 " << blob.size()
+              << ", 首字节 " << (blob.empty() ? '-' : blob[0])
+              << ", 流式读取 " << streamed << " 字节/" << chunks << " 块\n";
+
+    // 键值分离：大值写入值日志，覆盖产生的垃圾由后续写操作增量回收
+    blobTree.setValueLogEnabled(true, 1024);
+    for (int round = 0; round < 4; round++) {
+        blobTree.insert(3, std::string(3000, (char)('a' + round)));
+    }
+    uint64_t logBytes = blobTree.getValueLogBytes();
+    uint64_t logGarbage = blobTree.getValueLogGarbage();
+    blobTree.compactValueLog();
+    std::string logged;
+    blobTree.search(3, logged);
+    std::cout << "值日志: " << logBytes << " 字节(垃圾 " << logGarbage << ") -> 回收后 "
+              << blobTree.getValueLogBytes() << " 字节, key=3 首字节 " << logged[0] << "\n";
+
     return 0;
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #define PAGE_H
 
 #include "page_header.h"
+#include <algorithm>
 #include <cstring>
+#include <string>
 #include <vector>
 #include <stdexcept>
 
@@ -12,12 +14,15 @@ Slotted Page
 Byte Offset     Component              Description
 ============================================================
     0           +---------------------+
-                |   PAGE HEADER       |  32 bytes
-   32           +---------------------+
+                |   PAGE HEADER       |  30 bytes
+   30           +---------------------+
+                |   prefix_len (u16)  |  页内公共前缀（变长键页使用，
+                |   prefix bytes      |  定长页 prefix_len = 0）
+                +---------------------+
                 |   Slot 0            |  \
                 |   Slot 1            |   |  Slot Directory
                 |   Slot 2            |   |  (grows downward)
-                |   ...               |   |  Each slot: 4 bytes
+                |   ...               |   |  Each slot: 8 bytes (u16 offset, u16 length, u32 key hint)
                 |   Slot N-1          |  /
  lower_ptr      +---------------------+
                 |                     |
@@ -32,17 +37,35 @@ Byte Offset     Component              Description
                 |   Data Item 1       |   |  (grows upward)
                 |   Data Item 0       |  /   Each item: 8 bytes
  4096           +---------------------+
+
+Fixed-Width Page（FIXED_LEAF_PAGE / FIXED_INTERNAL_PAGE，定长元组不需要槽目录）
+============================================================
+    0           +---------------------+
+                |   PAGE HEADER       |  30 bytes
+   30           +---------------------+
+                |   prefix_len = 0    |  2 bytes
+   32           +---------------------+
+                |   keys[CAP]         |  有序 int32 键
+                +---------------------+
+                |   values[CAP]       |  叶子为 value，内部为 child_page_id
+                +---------------------+
+  每个条目 8 字节、没有槽开销，容量约为槽式页的两倍
 */
 
 // 槽目录
 #pragma pack(push, 1)
 struct SlotEntry {
-    uint32_t offset;  // Tuple 的起始位置
-    uint32_t length;  // Tuple 的长度
+    uint16_t offset;    // Tuple 的起始位置（页内偏移，PAGE_SIZE 小于 64KB）
+    uint16_t length;    // Tuple 的长度
+    uint32_t key_hint;  // 键提示：页内二分查找只读连续的槽目录，提示相等时才访问元组
 };
 #pragma pack(pop)
 
 static_assert(sizeof(SlotEntry) == 8, "SlotEntry size mismatch！！！");
+static_assert(PAGE_SIZE < 65536, "SlotEntry 的 16 位偏移与 upper_ptr 无法表示该页大小");
+
+// 死空间（已删除的槽与元组）少于此值时不整理页面，避免每次删除后都重写整页
+const uint16_t PAGE_COMPACT_THRESHOLD = 64;
 
 // 内部节点
 struct InternalNode {
@@ -56,6 +79,12 @@ struct LeafNode {
     int value;
 };
 
+/*
+变长键记录（键只保存去掉页内公共前缀后的后缀）
+  叶子：[u16 suffix_len][suffix][u16 value_len][value]
+  内部：[u16 suffix_len][suffix][u32 child_page_id]
+*/
+
 class Page {
 private:
     uint8_t data_[PAGE_SIZE];  // 4KB
@@ -63,19 +92,227 @@ private:
     bool dirty_;               // 脏页标记
     bool is_pinned_;           // 当前是否有线程正在使用这个页
 
-    // 获取槽数组起始偏移量
-    uint16_t get_slot_array_offset() const {
+    // 公共前缀区紧跟页头：[u16 prefix_len][prefix bytes]
+    uint16_t get_prefix_offset() const {
         return static_cast<uint16_t>(sizeof(PageHeader));
     }
 
-    // 获取特定槽位的 Key (用于二分查找)
-    int get_key_at_slot(uint16_t slot_idx) const {
+    uint16_t get_prefix_len() const {
+        return read_u16_le(data_ + get_prefix_offset());
+    }
+
+    // 获取槽数组起始偏移量（位于公共前缀之后）
+    uint16_t get_slot_array_offset() const {
+        return static_cast<uint16_t>(get_prefix_offset() + sizeof(uint16_t) + get_prefix_len());
+    }
+
+    bool is_varlen() const {
+        return header_.page_type == VARLEN_LEAF_PAGE || header_.page_type == VARLEN_INTERNAL_PAGE;
+    }
+
+    bool is_fixed() const {
+        return header_.page_type == FIXED_LEAF_PAGE || header_.page_type == FIXED_INTERNAL_PAGE;
+    }
+
+    // 定长页：键数组紧跟公共前缀区（前缀为空），值数组紧跟键数组
+    uint16_t get_fixed_keys_offset() const {
+        return get_slot_array_offset();
+    }
+
+    uint16_t get_fixed_values_offset() const {
+        return static_cast<uint16_t>(get_fixed_keys_offset() + FIXED_CAPACITY * sizeof(int32_t));
+    }
+
+    // 数组起点不保证对齐，按字节读写
+    int32_t fixed_key_at(uint16_t idx) const {
+        int32_t key;
+        std::memcpy(&key, data_ + get_fixed_keys_offset() + idx * sizeof(int32_t), sizeof(key));
+        return key;
+    }
+
+    uint32_t fixed_value_at(uint16_t idx) const {
+        uint32_t value;
+        std::memcpy(&value, data_ + get_fixed_values_offset() + idx * sizeof(uint32_t), sizeof(value));
+        return value;
+    }
+
+    // 第一个 >= key 的下标
+    uint16_t fixed_lower_bound(int key) const {
+        int left = 0, right = header_.key_count - 1;
+        while (left <= right) {
+            int mid = left + (right - left) / 2;
+            if (fixed_key_at(mid) < key) left = mid + 1;
+            else right = mid - 1;
+        }
+        return static_cast<uint16_t>(left);
+    }
+
+    // 变长记录中键后缀的位置与长度
+    const uint8_t* get_suffix_at_slot(uint16_t slot_idx, uint16_t& suffix_len) const {
+        const uint8_t* record = data_ + get_slot_ptr(slot_idx)->offset;
+        suffix_len = read_u16_le(record);
+        return record + sizeof(uint16_t);
+    }
+
+    // 变长记录中键之后的负载（叶子为 value 段，内部为 child_page_id）
+    std::string get_payload_at_slot(uint16_t slot_idx) const {
         const SlotEntry* slot = get_slot_ptr(slot_idx);
-        if (header_.page_type == LEAF_PAGE) {
-            return reinterpret_cast<const LeafNode*>(data_ + slot->offset)->key;
+        uint16_t suffix_len = read_u16_le(data_ + slot->offset);
+        uint32_t payload_offset = sizeof(uint16_t) + suffix_len;
+        return std::string(reinterpret_cast<const char*>(data_ + slot->offset + payload_offset),
+                           slot->length - payload_offset);
+    }
+
+    // 定长页的键提示：翻转符号位的整数键，保序且与键一一对应，不需要回查元组
+    static uint32_t int_key_hint(int key) {
+        return static_cast<uint32_t>(key) ^ 0x80000000u;
+    }
+
+    // 变长页的键提示：键后缀的前 4 个字节按大端拼成整数（不足补 0）
+    // 提示小则键小；提示相等时需比较元组中的完整后缀
+    static uint32_t suffix_key_hint(const uint8_t* suffix, size_t len) {
+        uint32_t hint = 0;
+        for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+            hint = (hint << 8) | (i < len ? suffix[i] : 0);
+        }
+        return hint;
+    }
+
+    static uint32_t suffix_key_hint(const std::string& suffix) {
+        return suffix_key_hint(reinterpret_cast<const uint8_t*>(suffix.data()), suffix.size());
+    }
+
+    // 与槽位中的键后缀比较（字节序），返回 <0 / 0 / >0
+    int compare_suffix(uint16_t slot_idx, const uint8_t* suffix, size_t len) const {
+        uint16_t slot_len;
+        const uint8_t* slot_suffix = get_suffix_at_slot(slot_idx, slot_len);
+        size_t n = std::min<size_t>(len, slot_len);
+        int c = n > 0 ? std::memcmp(suffix, slot_suffix, n) : 0;
+        if (c != 0) return c;
+        return len < slot_len ? -1 : (len > slot_len ? 1 : 0);
+    }
+
+    // 变长键的插入点：第一个 >= key 的槽位
+    // 不以页前缀开头的键整体小于或大于页内所有键
+    uint16_t find_var_insertion_point(const std::string& key) const {
+        std::string prefix = get_prefix();
+        size_t n = std::min(prefix.size(), key.size());
+        int c = key.compare(0, n, prefix, 0, n);
+        if (c < 0 || (c == 0 && key.size() < prefix.size())) return 0;
+        if (c > 0) return header_.key_count;
+
+        const uint8_t* suffix = reinterpret_cast<const uint8_t*>(key.data()) + prefix.size();
+        size_t suffix_len = key.size() - prefix.size();
+        uint32_t hint = suffix_key_hint(suffix, suffix_len);
+        int left = 0, right = header_.key_count - 1;
+        while (left <= right) {
+            int mid = left + (right - left) / 2;
+            uint32_t slot_hint = get_slot_ptr(mid)->key_hint;
+            int c = hint != slot_hint ? (hint < slot_hint ? -1 : 1) : compare_suffix(mid, suffix, suffix_len);
+            if (c > 0) left = mid + 1;
+            else right = mid - 1;
+        }
+        return static_cast<uint16_t>(left);
+    }
+
+    // 以给定前缀重新排布变长记录（records 为 {完整键, 负载} 且已按键排序）
+    // 排布后的总大小超过页面时不做修改并返回 false
+    bool layout_var_records(const std::string& prefix,
+                            const std::vector<std::pair<std::string, std::string> >& records) {
+        size_t total = sizeof(PageHeader) + sizeof(uint16_t) + prefix.size();
+        for (size_t i = 0; i < records.size(); ++i) {
+            total += sizeof(SlotEntry) + sizeof(uint16_t) + (records[i].first.size() - prefix.size()) +
+                     records[i].second.size();
+        }
+        if (total > PAGE_SIZE) return false;
+
+        write_u16_le(data_ + get_prefix_offset(), static_cast<uint16_t>(prefix.size()));
+        std::memcpy(data_ + get_prefix_offset() + sizeof(uint16_t), prefix.data(), prefix.size());
+        header_.key_count = 0;
+        header_.upper_ptr = static_cast<uint16_t>(PAGE_SIZE);
+        header_.lower_ptr = get_slot_array_offset();
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            append_var_record(records[i].first.substr(prefix.size()), records[i].second);
+        }
+        dirty_ = true;
+        return true;
+    }
+
+    // 在槽目录末尾追加一条变长记录（调用方保证有序且空间足够）
+    void append_var_record(const std::string& suffix, const std::string& payload) {
+        uint16_t item_size = static_cast<uint16_t>(sizeof(uint16_t) + suffix.size() + payload.size());
+        header_.upper_ptr -= item_size;
+        uint8_t* record = data_ + header_.upper_ptr;
+        write_u16_le(record, static_cast<uint16_t>(suffix.size()));
+        std::memcpy(record + sizeof(uint16_t), suffix.data(), suffix.size());
+        std::memcpy(record + sizeof(uint16_t) + suffix.size(), payload.data(), payload.size());
+
+        SlotEntry se{header_.upper_ptr, item_size, suffix_key_hint(suffix)};
+        write_slot_to_buffer(header_.key_count, se);
+        header_.key_count++;
+        header_.lower_ptr += sizeof(SlotEntry);
+    }
+
+    // 收集页内全部变长记录，可额外并入一条（按序插入）
+    std::vector<std::pair<std::string, std::string> > collect_var_records() const {
+        std::vector<std::pair<std::string, std::string> > records;
+        for (uint16_t i = 0; i < header_.key_count; ++i) {
+            records.push_back(std::make_pair(get_var_key(i), get_payload_at_slot(i)));
+        }
+        return records;
+    }
+
+    static size_t common_prefix_len(const std::string& a, const std::string& b) {
+        size_t n = std::min(a.size(), b.size());
+        size_t i = 0;
+        while (i < n && a[i] == b[i]) ++i;
+        return i;
+    }
+
+    // 插入一条变长记录：键不以页前缀开头时缩短前缀并重排整页；空间不足时先整理再重试
+    bool insert_var_record(const std::string& key, const std::string& payload) {
+        std::string prefix = get_prefix();
+        uint16_t target_idx = find_var_insertion_point(key);
+        bool exists = target_idx < header_.key_count && get_var_key(target_idx) == key;
+        size_t item_size = sizeof(uint16_t) + (key.size() - std::min(key.size(), prefix.size())) + payload.size();
+
+        if (common_prefix_len(prefix, key) == prefix.size() && !exists &&
+            header_.lower_ptr + sizeof(SlotEntry) + item_size <= header_.upper_ptr) {
+            uint8_t* slot_array_ptr = data_ + get_slot_array_offset();
+            if (target_idx < header_.key_count) {
+                std::memmove(
+                    slot_array_ptr + (target_idx + 1) * sizeof(SlotEntry),
+                    slot_array_ptr + target_idx * sizeof(SlotEntry),
+                    (header_.key_count - target_idx) * sizeof(SlotEntry)
+                );
+            }
+            uint16_t record_size = static_cast<uint16_t>(item_size);
+            header_.upper_ptr -= record_size;
+            uint8_t* record = data_ + header_.upper_ptr;
+            std::string suffix = key.substr(prefix.size());
+            write_u16_le(record, static_cast<uint16_t>(suffix.size()));
+            std::memcpy(record + sizeof(uint16_t), suffix.data(), suffix.size());
+            std::memcpy(record + sizeof(uint16_t) + suffix.size(), payload.data(), payload.size());
+
+            SlotEntry se{header_.upper_ptr, record_size, suffix_key_hint(suffix)};
+            write_slot_to_buffer(target_idx, se);
+            header_.key_count++;
+            header_.lower_ptr += sizeof(SlotEntry);
+            dirty_ = true;
+            return true;
+        }
+
+        // 慢路径：取出全部记录，替换/插入后按新前缀整体重排（同时回收已删除记录的空间）
+        std::vector<std::pair<std::string, std::string> > records = collect_var_records();
+        if (exists) {
+            records[target_idx].second = payload;
         } else {
-            return reinterpret_cast<const InternalNode*>(data_ + slot->offset)->key;
+            records.insert(records.begin() + target_idx, std::make_pair(key, payload));
         }
+        std::string new_prefix = records.front().first.substr(
+            0, common_prefix_len(records.front().first, records.back().first));
+        return layout_var_records(new_prefix, records);
     }
 
     // 获取槽位指针（原始位置）
@@ -87,26 +324,42 @@ private:
         return reinterpret_cast<const SlotEntry*>(data_ + get_slot_array_offset() + (slot_idx * sizeof(SlotEntry)));
     }
 
+    // 空闲区放不下 needed 字节时，死空间足够多且整理后放得下才整理一次
+    bool compact_if_worthwhile(uint16_t needed) {
+        uint16_t dead = get_dead_space();
+        if (dead < PAGE_COMPACT_THRESHOLD || get_free_space() + dead < needed) {
+            return false;
+        }
+        compact();
+        return true;
+    }
+
     // 写入槽位信息
     void write_slot_to_buffer(uint16_t slot_idx, const SlotEntry& se) {
         std::memcpy(get_slot_ptr(slot_idx), &se, sizeof(SlotEntry));
     }
 
     // 寻找插入点：返回第一个 key >= target_key 的槽位索引 (二分查找)
+    // 只比较槽目录中的键提示，不访问元组
     uint16_t find_insertion_point(int target_key) const {
+        uint32_t target_hint = int_key_hint(target_key);
         int left = 0, right = header_.key_count - 1;
         while (left <= right) {
             int mid = left + (right - left) / 2;
-            if (get_key_at_slot(mid) < target_key) left = mid + 1;
+            if (get_slot_ptr(mid)->key_hint < target_hint) left = mid + 1;
             else right = mid - 1;
         }
         return static_cast<uint16_t>(left);
     }
 
 public:
+    // 定长页的条目容量：页头与空前缀之后全部用于键数组和值数组
+    static constexpr uint16_t FIXED_CAPACITY =
+        (PAGE_SIZE - sizeof(PageHeader) - sizeof(uint16_t)) / (sizeof(int32_t) + sizeof(uint32_t));
+
     Page() : dirty_(false), is_pinned_(false) {
         std::memset(data_, 0, PAGE_SIZE);
-        init_header();
+        init_header(0, LEAF_PAGE);
     }
 
     void init_header(uint32_t page_id, uint16_t type) {
@@ -117,7 +370,8 @@ public:
     header_.lsn = 0;
     header_.page_id = page_id;
     header_.upper_ptr = static_cast<uint16_t>(PAGE_SIZE); 
-    header_.lower_ptr = static_cast<uint16_t>(sizeof(PageHeader)); 
+    write_u16_le(data_ + get_prefix_offset(), 0);  // 空前缀
+    header_.lower_ptr = get_slot_array_offset(); 
     header_.key_count = 0;           
 
     serialize_to_buffer();
@@ -166,7 +420,10 @@ public:
     }
 
     // 是否为叶子节点
-    bool is_leaf() const { return header_.page_type == LEAF_PAGE; }
+    bool is_leaf() const {
+        return header_.page_type == LEAF_PAGE || header_.page_type == VARLEN_LEAF_PAGE ||
+               header_.page_type == FIXED_LEAF_PAGE;
+    }
     void set_leaf(bool is_leaf) {
         header_.page_type = is_leaf ? LEAF_PAGE : INTERNAL_PAGE;
         serialize_to_buffer();
@@ -177,6 +434,9 @@ public:
 
     // 获取空闲空间大小
     uint16_t get_free_space() const {
+        if (is_fixed()) {
+            return static_cast<uint16_t>((FIXED_CAPACITY - header_.key_count) * (sizeof(int32_t) + sizeof(uint32_t)));
+        }
         return header_.upper_ptr - header_.lower_ptr;
     }
 
@@ -191,10 +451,10 @@ public:
 
     // 获取槽目录项
     SlotEntry* get_slot(uint16_t slot_idx) {
-        if (slot_idx >= header_.key_count) {
+        if (slot_idx >= header_.key_count || is_fixed()) {
             return nullptr;
         }
-        uint16_t slot_offset = sizeof(PageHeader) + slot_idx * sizeof(SlotEntry);
+        uint16_t slot_offset = get_slot_array_offset() + slot_idx * sizeof(SlotEntry);
         return reinterpret_cast<SlotEntry*>(data_ + slot_offset);
     }
 
@@ -211,25 +471,21 @@ public:
     uint16_t target_idx = find_insertion_point(key);
 
     // 计算本次操作对连续空闲区的绝对消耗
-    // 消耗 = 新槽位 + 数据 + 预留给目录的增长
-    uint16_t total_consumption = sizeof(SlotEntry) + item_size + dir_growth;
+    // 消耗 = 新槽位 + 数据
+    uint16_t total_consumption = sizeof(SlotEntry) + item_size;
 
     // 严格检查：确保中间 Free 区足以容纳
-    if (header_.lower_ptr + total_consumption > header_.upper_ptr - current_dir_space) {
-        // 问题 4 的对策：如果空间不足，尝试 Purge（物理删除那些标为 dead 的索引槽）
-        // if (has_dead_slots()) { purge_index_page(); return insert_index_item(...); }
-        return false; 
+    if (header_.lower_ptr + total_consumption > header_.upper_ptr) {
+        // 空间不足：整理掉标为 dead 的槽及其元组后再插入，整理不值得或仍放不下时由上层分裂
+        if (!compact_if_worthwhile(total_consumption)) {
+            return false;
+        }
+        slot_array_ptr = data_ + get_slot_array_offset();
+        target_idx = find_insertion_point(key);
     }
 
     // --- 物理落地阶段 ---
 
-    // 4. 目录空间预留落地（解决问题 1 的核心：先挪指针，后写数据）
-    if (needs_new_dir) {
-        // 注意：PageDir 位于数据区之上，所以我们要压低有效的 upper 界限
-        // 我们不立即写 Directory，但必须通过某种方式标记这块地被占了
-        reserve_directory_space(sizeof(uint16_t)); 
-    }
-
     // 5. 槽位挪移（保持有序）
     if (target_idx < header_.key_count) {
         std::memmove(
@@ -241,13 +497,13 @@ public:
 
     // 6. 数据写入 (Scheme B)
     header_.upper_ptr -= item_size;
-    std::memcpy(data_ + header_.upper_ptr, key_data, item_size);
+    std::memcpy(data_ + header_.upper_ptr, item_data, item_size);
 
     // 7. 更新元数据 (解决问题 3：Key_count 仅在 Index 上下文代表记录数)
     header_.key_count++; 
     header_.lower_ptr += sizeof(SlotEntry);
 
-    SlotEntry se{header_.upper_ptr, item_size};
+    SlotEntry se{header_.upper_ptr, item_size, int_key_hint(key)};
     write_slot_to_buffer(target_idx, se);
 
     slot_idx = target_idx;
@@ -258,16 +514,22 @@ public:
 
     // 插入叶子节点条目
     bool insert_leaf_entry(int key, int value) {
+        if (header_.page_type == FIXED_LEAF_PAGE) {
+            return insert_fixed_entry(key, static_cast<uint32_t>(value));
+        }
         LeafNode entry{key, value};
         uint16_t slot_idx;
-        return insert_item(&entry, sizeof(LeafNode), slot_idx);
+        return insert_index_item(&entry, sizeof(LeafNode), key, slot_idx);
     }
 
     // 插入内部节点条目
     bool insert_internal_entry(int key, uint32_t child_page_id) {
+        if (header_.page_type == FIXED_INTERNAL_PAGE) {
+            return insert_fixed_entry(key, child_page_id);
+        }
         InternalNode entry{key, child_page_id};
         uint16_t slot_idx;
-        return insert_item(&entry, sizeof(InternalNode), slot_idx);
+        return insert_index_item(&entry, sizeof(InternalNode), key, slot_idx);
     }
 
     // 获取叶子节点条目
@@ -275,10 +537,13 @@ public:
         if (slot_idx >= header_.key_count || !is_leaf()) {
             return false;
         }
+        if (is_fixed()) {
+            entry.key = fixed_key_at(slot_idx);
+            entry.value = static_cast<int>(fixed_value_at(slot_idx));
+            return true;
+        }
         
-        const SlotEntry* slot = reinterpret_cast<const SlotEntry*>(
-            data_ + sizeof(PageHeader) + slot_idx * sizeof(SlotEntry)
-        );
+        const SlotEntry* slot = get_slot_ptr(slot_idx);
         
         std::memcpy(&entry, data_ + slot->offset, sizeof(LeafNode));
         return true;
@@ -289,20 +554,29 @@ public:
         if (slot_idx >= header_.key_count || is_leaf()) {
             return false;
         }
+        if (is_fixed()) {
+            entry.key = fixed_key_at(slot_idx);
+            entry.child_page_id = fixed_value_at(slot_idx);
+            return true;
+        }
         
-        const SlotEntry* slot = reinterpret_cast<const SlotEntry*>(
-            data_ + sizeof(PageHeader) + slot_idx * sizeof(SlotEntry)
-        );
+        const SlotEntry* slot = get_slot_ptr(slot_idx);
         
         std::memcpy(&entry, data_ + slot->offset, sizeof(InternalNode));
         return true;
     }
 
-    // 逻辑删除条目（标记槽为无效）
+    // 逻辑删除条目（标记槽为无效）；变长键页直接从槽目录移除
     bool delete_item(uint16_t slot_idx) {
         if (slot_idx >= header_.key_count) {
             return false;
         }
+        if (is_fixed()) {
+            return erase_fixed_entry(slot_idx);  // 定长页没有槽，直接物理删除
+        }
+        if (is_varlen()) {
+            return erase_var_entry(slot_idx);  // 变长记录按槽读取负载，不能留下长度为 0 的槽
+        }
 
         SlotEntry* slot = get_slot(slot_idx);
         if (!slot) return false;
@@ -315,40 +589,48 @@ public:
         return true;
     }
 
-    // 搜索键（二分查找，要求键已排序）
-    int search_key(int key) const {
-        int left = 0, right = header_.key_count - 1;
-        int result = -1;
-        
-        while (left <= right) {
-            int mid = left + (right - left) / 2;
-            
-            int mid_key;
-            if (is_leaf()) {
-                LeafNode entry;
-                if (!const_cast<Page*>(this)->get_leaf_entry(mid, entry)) {
-                    break;
-                }
-                mid_key = entry.key;
-            } else {
-                InternalNode entry;
-                if (!const_cast<Page*>(this)->get_internal_entry(mid, entry)) {
-                    break;
-                }
-                mid_key = entry.key;
-            }
-            
-            if (mid_key == key) {
-                return mid;
-            } else if (mid_key < key) {
-                left = mid + 1;
-            } else {
-                result = mid;
-                right = mid - 1;
-            }
+    // 死空间：标为 dead 的槽位，加上数据区中不再被任何存活槽引用的字节
+    // （已删除元组、变长页中移出目录的记录）
+    uint16_t get_dead_space() const {
+        if (is_fixed()) return 0;
+        uint32_t live_bytes = 0;
+        uint16_t dead_slots = 0;
+        for (uint16_t i = 0; i < header_.key_count; ++i) {
+            const SlotEntry* slot = get_slot_ptr(i);
+            if (slot->length == 0) dead_slots++;
+            else live_bytes += slot->length;
         }
-        
-        return result;  // 返回第一个 >= key 的位置，如果不存在返回-1
+        return static_cast<uint16_t>(PAGE_SIZE - header_.upper_ptr - live_bytes + dead_slots * sizeof(SlotEntry));
+    }
+
+    // 整理页面：丢弃 dead 槽，把存活元组紧凑地排到页尾
+    // 按槽序一遍完成：元组依次复制到临时缓冲区尾部，槽目录原地前移（写入位置不超过读取位置）
+    // 整理后槽位下标会变化，存活条目的相对顺序不变
+    void compact() {
+        if (is_fixed()) return;
+        uint8_t scratch[PAGE_SIZE];
+        uint16_t upper = static_cast<uint16_t>(PAGE_SIZE);
+        uint16_t live = 0;
+        for (uint16_t i = 0; i < header_.key_count; ++i) {
+            SlotEntry se = *get_slot_ptr(i);
+            if (se.length == 0) continue;
+            upper -= se.length;
+            std::memcpy(scratch + upper, data_ + se.offset, se.length);
+            se.offset = upper;
+            write_slot_to_buffer(live++, se);
+        }
+        std::memcpy(data_ + upper, scratch + upper, PAGE_SIZE - upper);
+
+        header_.key_count = live;
+        header_.upper_ptr = upper;
+        header_.lower_ptr = get_slot_array_offset() + live * sizeof(SlotEntry);
+        dirty_ = true;
+    }
+
+    // 搜索键（二分查找，要求键已排序；只读槽目录中的键提示）
+    int search_key(int key) const {
+        uint16_t pos = is_fixed() ? fixed_lower_bound(key) : find_insertion_point(key);
+        return pos < header_.key_count ? pos : -1;  // 返回第一个 >= key 的位置，如果不存在返回-1
     }
 
     // 线性搜索键（用于未排序的页面）
@@ -373,6 +655,158 @@ public:
         return -1;  // 未找到
     }
 
+    // ============ 定长页 ============
+    // 键与值（或孩子页号）各自存为有序数组，没有槽目录，每个条目只占 8 字节
+    // insert_leaf_entry / get_leaf_entry / search_key / delete_item 等接口对定长页同样适用
+
+    // 初始化为空的定长页
+    void init_fixed(uint32_t page_id, bool leaf) {
+        init_header(page_id, leaf ? FIXED_LEAF_PAGE : FIXED_INTERNAL_PAGE);
+    }
+
+    // 按键序插入（与槽式页相同，键相等时插在已有条目之前），页满时返回 false
+    bool insert_fixed_entry(int key, uint32_t value) {
+        if (!is_fixed() || header_.key_count >= FIXED_CAPACITY) return false;
+        uint16_t pos = fixed_lower_bound(key);
+        uint8_t* keys = data_ + get_fixed_keys_offset();
+        uint8_t* values = data_ + get_fixed_values_offset();
+        std::memmove(keys + (pos + 1) * sizeof(int32_t), keys + pos * sizeof(int32_t),
+                     (header_.key_count - pos) * sizeof(int32_t));
+        std::memmove(values + (pos + 1) * sizeof(uint32_t), values + pos * sizeof(uint32_t),
+                     (header_.key_count - pos) * sizeof(uint32_t));
+        int32_t stored_key = key;
+        std::memcpy(keys + pos * sizeof(int32_t), &stored_key, sizeof(stored_key));
+        std::memcpy(values + pos * sizeof(uint32_t), &value, sizeof(value));
+        header_.key_count++;
+        dirty_ = true;
+        return true;
+    }
+
+    bool get_fixed_entry(uint16_t slot_idx, int& key, uint32_t& value) const {
+        if (slot_idx >= header_.key_count || !is_fixed()) return false;
+        key = fixed_key_at(slot_idx);
+        value = fixed_value_at(slot_idx);
+        return true;
+    }
+
+    bool erase_fixed_entry(uint16_t slot_idx) {
+        if (slot_idx >= header_.key_count || !is_fixed()) return false;
+        uint8_t* keys = data_ + get_fixed_keys_offset();
+        uint8_t* values = data_ + get_fixed_values_offset();
+        std::memmove(keys + slot_idx * sizeof(int32_t), keys + (slot_idx + 1) * sizeof(int32_t),
+                     (header_.key_count - slot_idx - 1) * sizeof(int32_t));
+        std::memmove(values + slot_idx * sizeof(uint32_t), values + (slot_idx + 1) * sizeof(uint32_t),
+                     (header_.key_count - slot_idx - 1) * sizeof(uint32_t));
+        header_.key_count--;
+        dirty_ = true;
+        return true;
+    }
+
+    // ============ 变长键（前缀压缩） ============
+    // 键按字节序比较，std::string 可容纳任意字节
+    // 页内所有键共享的前缀只存一次，记录中只保存后缀
+    // 目前是独立的存储层页格式，PagedBPlusTree 仍使用定长键数组，只在分隔键上做后缀截断
+
+    // 初始化为空的变长键页
+    void init_varlen(uint32_t page_id, bool leaf) {
+        init_header(page_id, leaf ? VARLEN_LEAF_PAGE : VARLEN_INTERNAL_PAGE);
+    }
+
+    // 页内公共前缀
+    std::string get_prefix() const {
+        return std::string(reinterpret_cast<const char*>(data_ + get_prefix_offset() + sizeof(uint16_t)),
+                           get_prefix_len());
+    }
+
+    // 还原槽位中的完整键（前缀 + 后缀）
+    std::string get_var_key(uint16_t slot_idx) const {
+        uint16_t suffix_len;
+        const uint8_t* suffix = get_suffix_at_slot(slot_idx, suffix_len);
+        return get_prefix() + std::string(reinterpret_cast<const char*>(suffix), suffix_len);
+    }
+
+    // 插入/覆盖叶子条目，页面放不下时返回 false（由上层分裂）
+    bool insert_var_leaf_entry(const std::string& key, const std::string& value) {
+        if (header_.page_type != VARLEN_LEAF_PAGE) return false;
+        std::string payload(sizeof(uint16_t), '\0');
+        write_u16_le(reinterpret_cast<uint8_t*>(&payload[0]), static_cast<uint16_t>(value.size()));
+        payload += value;
+        return insert_var_record(key, payload);
+    }
+
+    // 插入内部条目：separator 为右侧子树的分隔键（通常已经过 shortest_separator 截断）
+    bool insert_var_internal_entry(const std::string& separator, uint32_t child_page_id) {
+        if (header_.page_type != VARLEN_INTERNAL_PAGE) return false;
+        std::string payload(sizeof(uint32_t), '\0');
+        write_u32_le(reinterpret_cast<uint8_t*>(&payload[0]), child_page_id);
+        return insert_var_record(separator, payload);
+    }
+
+    bool get_var_leaf_entry(uint16_t slot_idx, std::string& key, std::string& value) const {
+        if (slot_idx >= header_.key_count || header_.page_type != VARLEN_LEAF_PAGE) return false;
+        key = get_var_key(slot_idx);
+        std::string payload = get_payload_at_slot(slot_idx);
+        value = payload.substr(sizeof(uint16_t), read_u16_le(reinterpret_cast<const uint8_t*>(payload.data())));
+        return true;
+    }
+
+    bool get_var_internal_entry(uint16_t slot_idx, std::string& separator, uint32_t& child_page_id) const {
+        if (slot_idx >= header_.key_count || header_.page_type != VARLEN_INTERNAL_PAGE) return false;
+        separator = get_var_key(slot_idx);
+        child_page_id = read_u32_le(reinterpret_cast<const uint8_t*>(get_payload_at_slot(slot_idx).data()));
+        return true;
+    }
+
+    // 精确查找变长键，返回槽位，不存在返回 -1
+    int search_var_key(const std::string& key) const {
+        uint16_t idx = find_var_insertion_point(key);
+        if (idx < header_.key_count && get_var_key(idx) == key) return idx;
+        return -1;
+    }
+
+    // 第一个 >= key 的槽位（可能等于 key_count）
+    uint16_t lower_bound_var_key(const std::string& key) const {
+        return find_var_insertion_point(key);
+    }
+
+    // 从槽目录中移除条目，记录占用的字节在下次重排时回收
+    bool erase_var_entry(uint16_t slot_idx) {
+        if (slot_idx >= header_.key_count || !is_varlen()) return false;
+        uint8_t* slot_array_ptr = data_ + get_slot_array_offset();
+        std::memmove(
+            slot_array_ptr + slot_idx * sizeof(SlotEntry),
+            slot_array_ptr + (slot_idx + 1) * sizeof(SlotEntry),
+            (header_.key_count - slot_idx - 1) * sizeof(SlotEntry)
+        );
+        header_.key_count--;
+        header_.lower_ptr -= sizeof(SlotEntry);
+        dirty_ = true;
+        return true;
+    }
+
+    // 把 [begin, key_count) 的条目搬到空的变长键页 dest（分裂用），两页各自重新计算前缀
+    bool move_var_entries_to(uint16_t begin, Page& dest) {
+        if (!is_varlen() || dest.header_.page_type != header_.page_type || begin > header_.key_count) return false;
+        std::vector<std::pair<std::string, std::string> > records = collect_var_records();
+        std::vector<std::pair<std::string, std::string> > left(records.begin(), records.begin() + begin);
+        std::vector<std::pair<std::string, std::string> > right(records.begin() + begin, records.end());
+        std::string left_prefix, right_prefix;
+        if (!left.empty()) {
+            left_prefix = left.front().first.substr(0, common_prefix_len(left.front().first, left.back().first));
+        }
+        if (!right.empty()) {
+            right_prefix = right.front().first.substr(0, common_prefix_len(right.front().first, right.back().first));
+        }
+        return dest.layout_var_records(right_prefix, right) && layout_var_records(left_prefix, left);
+    }
+
+    // 后缀截断：返回介于 left_max 与 right_min 之间（left_max < sep <= right_min）的最短分隔键
+    // 只取 right_min 的最短前缀，使内部页的分隔键尽量短、扇出尽量大
+    static std::string shortest_separator(const std::string& left_max, const std::string& right_min) {
+        size_t i = common_prefix_len(left_max, right_min);
+        return right_min.substr(0, std::min(i + 1, right_min.size()));
+    }
+
     // 更新 LSN（日志序列号）
     void set_lsn(uint64_t lsn) {
         header_.lsn = lsn;
@@ -389,6 +823,7 @@ public:
         std::cout << "Page ID: " << header_.page_id << std::endl;
         std::cout << "Is Leaf: " << (is_leaf() ? "Yes" : "No") << std::endl;
         std::cout << "Key Count: " << header_.key_count << std::endl;
+        std::cout << "Prefix Length: " << get_prefix_len() << std::endl;
         std::cout << "Free Space: " << get_free_space() << " bytes" << std::endl;
         std::cout << "LSN: " << header_.lsn << std::endl;
         std::cout << "Upper Ptr: " << header_.upper_ptr << std::endl;
@@ -415,4 +850,8 @@ public:
     }
 };
 
+#if __cplusplus < 201703L
+constexpr uint16_t Page::FIXED_CAPACITY;  // C++17 之前 ODR 使用（如按引用传给 std::min）需要类外定义
+#endif
+
 #endif // PAGE_H
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "page.h"
+
+// 页面布局测试：槽式页、定长页、变长键页
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "✓ " : "✗ ") << what << "\n";
+    if (!ok) failures++;
+}
+
+int main() {
+    std::cout << "========== 页面布局测试 ==========\n";
+
+    // 测试1: 槽式叶子页，删除后空间不足时整理 dead 槽
+    std::cout << "\n===== 测试1: 槽式叶子页 =====\n";
+    Page slotted;
+    slotted.init_header(1, LEAF_PAGE);
+    int inserted = 0;
+    while (slotted.insert_leaf_entry(inserted * 2, inserted * 100)) inserted++;
+    std::cout << "页满前插入 " << inserted << " 条\n";
+
+    LeafNode entry;
+    int pos = slotted.search_key(10);
+    check(pos >= 0 && slotted.get_leaf_entry(pos, entry) && entry.key == 10 && entry.value == 500,
+          "key=10 -> 500");
+
+    for (int i = 0; i < 16; i++) slotted.delete_item(i);
+    std::cout << "删除 16 条后死空间: " << slotted.get_dead_space() << " 字节\n";
+    bool ok = slotted.insert_leaf_entry(-1, 7);
+    check(ok && slotted.get_dead_space() == 0 && slotted.get_key_count() == inserted - 15,
+          "整理 dead 槽后插入 key=-1");
+    check(slotted.get_leaf_entry(0, entry) && entry.key == -1, "key=-1 位于槽 0");
+
+    // 测试2: 定长页
+    std::cout << "\n===== 测试2: 定长页 =====\n";
+    Page fixed;
+    fixed.init_fixed(2, true);
+    ok = true;
+    for (int i = Page::FIXED_CAPACITY - 1; i >= 0; i--) {
+        ok = fixed.insert_leaf_entry(i, i + 1) && ok;
+    }
+    check(ok && !fixed.insert_leaf_entry(-1, 0) &&
+          std::min(fixed.get_free_space(), Page::FIXED_CAPACITY) == 0,
+          "定长页装满 " + std::to_string(fixed.get_key_count()) + " 条");
+    pos = fixed.search_key(300);
+    check(pos == 300 && fixed.get_leaf_entry(pos, entry) && entry.value == 301, "key=300 -> 301");
+    ok = fixed.delete_item(0);
+    check(ok && fixed.search_key(0) == 0 && fixed.get_key_count() == Page::FIXED_CAPACITY - 1, "删除首条");
+
+    // 测试3: 变长键叶子页（前缀压缩）
+    std::cout << "\n===== 测试3: 变长键叶子页 =====\n";
+    Page varlen;
+    varlen.init_varlen(3, true);
+    ok = true;
+    for (int i = 0; i < 10; i++) {
+        ok = varlen.insert_var_leaf_entry("user:" + std::to_string(1000 + i), "v" + std::to_string(i)) && ok;
+    }
+    check(ok && varlen.get_key_count() == 10, "插入 10 个变长键");
+
+    ok = varlen.delete_item(3);
+    check(ok && varlen.get_key_count() == 9 && varlen.search_var_key("user:1003") == -1, "删除 user:1003");
+
+    // 覆盖已有键走慢路径，整页按新前缀重排
+    ok = varlen.insert_var_leaf_entry("user:1005", "updated");
+    std::string key, value;
+    int slot = varlen.search_var_key("user:1005");
+    check(ok && slot >= 0 && varlen.get_var_leaf_entry(slot, key, value) && value == "updated",
+          "覆盖 user:1005，重排后前缀 " + varlen.get_prefix());
+
+    // 插入不共享前缀的键，前缀缩短
+    ok = varlen.insert_var_leaf_entry("admin", "root");
+    check(ok && varlen.get_prefix().empty() && varlen.search_var_key("admin") == 0, "插入 admin 后前缀为空");
+
+    // 分裂：后半部分搬到新页，两页各自重算前缀
+    Page right;
+    right.init_varlen(4, true);
+    ok = varlen.move_var_entries_to(varlen.get_key_count() / 2, right);
+    std::string leftMax, rightMin;
+    varlen.get_var_leaf_entry(varlen.get_key_count() - 1, leftMax, value);
+    right.get_var_leaf_entry(0, rightMin, value);
+    check(ok && varlen.get_key_count() + right.get_key_count() == 10,
+          "分裂后右页前缀 " + right.get_prefix() + "，分隔键 " + Page::shortest_separator(leftMax, rightMin));
+
+    // 测试4: 校验和
+    std::cout << "\n===== 测试4: 校验和 =====\n";
+    right.serialize_to_buffer();
+    ok = right.deserialize_from_buffer();
+    right.get_data()[PAGE_SIZE - 1] ^= 0xFF;
+    check(ok && !right.deserialize_from_buffer(), "篡改页尾字节后校验失败");
+
+    std::cout << "\n========== 测试完成 ==========\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -12,7 +12,11 @@ const int MAX_KEYS_PER_PAGE = 100;  // 每页最大键数
 
 enum PageType : uint8_t {
     INTERNAL_PAGE = 1,
-    LEAF_PAGE = 2
+    LEAF_PAGE = 2,
+    VARLEN_INTERNAL_PAGE = 3,  // 变长键内部页（页内公共前缀压缩）
+    VARLEN_LEAF_PAGE = 4,      // 变长键叶子页（页内公共前缀压缩）
+    FIXED_INTERNAL_PAGE = 5,   // 定长内部页（无槽目录，键/孩子为有序数组）
+    FIXED_LEAF_PAGE = 6        // 定长叶子页（无槽目录，键/值为有序数组）
 };
 
 #pragma pack(push, 1)  // 强制字节对齐为1，禁止编译器插入Padding（跨编译器一致）